@@ -0,0 +1,221 @@
+// BidTable.cpp
+#include "BidTable.hpp"
+#include "GameState.hpp"
+#include "Player.hpp"
+#include "SuitSymmetry.hpp"
+#include "WorkStealing.hpp"
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// A table file is this header followed by NUM_ENTRIES bytes
+struct BidTableHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t rollouts;
+};
+
+static const char MAGIC[8] = {'E', 'U', 'C', 'H', 'R', 'E', 'B', 'T'};
+static const uint32_t VERSION = 2;
+
+// BINOMIAL[n][k] is n choose k, for ranking hands
+static constexpr array<array<int, 6>, Hand::NUM_CARDS + 1> make_binomials() {
+  array<array<int, 6>, Hand::NUM_CARDS + 1> b = {};
+  for (int n = 0; n <= Hand::NUM_CARDS; ++n) {
+    b[n][0] = 1;
+    for (int k = 1; k < 6 && k <= n; ++k) {
+      b[n][k] = b[n - 1][k - 1] + (k < n ? b[n - 1][k] : 0);
+    }
+  }
+  return b;
+}
+
+static constexpr array<array<int, 6>, Hand::NUM_CARDS + 1> BINOMIAL =
+    make_binomials();
+static_assert(BINOMIAL[Hand::NUM_CARDS][5] == BidTable::NUM_HANDS,
+              "NUM_HANDS should be 24 choose 5");
+
+BidTable::~BidTable() {
+  if (mapping) {
+    munmap(mapping, mapping_size);
+  }
+}
+
+bool BidTable::open(const string &path) {
+  assert(!mapping);
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  const size_t size = sizeof(BidTableHeader) + NUM_ENTRIES;
+  void *base = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && size_t(st.st_size) == size) {
+    base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+
+  BidTableHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+      || header.version != VERSION) {
+    munmap(base, size);
+    return false;
+  }
+  mapping = base;
+  mapping_size = size;
+  entries = static_cast<const unsigned char *>(base) + sizeof(header);
+  rollouts = header.rollouts;
+  return true;
+}
+
+const BidTable * BidTable::shared(const string &path) {
+  static mutex lock;
+  static map<string, unique_ptr<BidTable>> tables;
+  lock_guard<mutex> guard(lock);
+  auto found = tables.find(path);
+  if (found == tables.end()) {
+    unique_ptr<BidTable> table(new BidTable());
+    if (!table->open(path)) {
+      table.reset();
+    }
+    found = tables.emplace(path, std::move(table)).first;
+  }
+  return found->second.get();
+}
+
+double BidTable::win_probability(Hand hand, const Card &upcard, int position,
+                                 Suit suit) const {
+  assert(entries);
+  return entries[index(hand, upcard, position, suit)] / 255.0;
+}
+
+size_t BidTable::index(Hand hand, const Card &upcard, int position,
+                       Suit suit) {
+  assert(hand.size() == 5 && !hand.contains(upcard));
+  assert(0 <= position && position < NUM_POSITIONS);
+  const CanonicalBid bid = canonicalize(hand, upcard);
+  // Colex rank: the sum of (bit choose k) over the hand's k-th lowest bit
+  size_t rank = 0;
+  int k = 1;
+  for (uint32_t bits = bid.hand.get_bits(); bits; bits &= bits - 1) {
+    rank += BINOMIAL[__builtin_ctz(bits)][k++];
+  }
+  const int up = bid.upcard.get_rank() - NINE;
+  const Suit relabeled = bid.to_original.inverse()(suit);
+  return ((rank * NUM_UPCARDS + up) * NUM_POSITIONS + position) * 4
+         + relabeled;
+}
+
+Hand BidTable::hand_at(int rank) {
+  assert(0 <= rank && rank < NUM_HANDS);
+  uint32_t bits = 0;
+  int bit = Hand::NUM_CARDS;
+  for (int k = 5; k >= 1; --k) {
+    do {
+      --bit;
+    } while (BINOMIAL[bit][k] > rank);
+    rank -= BINOMIAL[bit][k];
+    bits |= uint32_t(1) << bit;
+  }
+  return Hand(bits);
+}
+
+bool BidTable::write(const string &path, int rollouts,
+                     const vector<unsigned char> &entries) {
+  assert(entries.size() == NUM_ENTRIES);
+  BidTableHeader header;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.rollouts = rollouts;
+  ofstream out(path, ios::binary);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(entries.data()), entries.size());
+  return bool(out);
+}
+
+double simulate_bid(Hand hand, const Card &upcard, int position, Suit suit,
+                    int rollouts, Rng &rng) {
+  // The dealer sits in seat 3, so position is also the seat
+  const int dealer = BidTable::NUM_POSITIONS - 1;
+  const int seat = position;
+  const bool round1 = suit == upcard.get_suit();
+
+  array<Card, Hand::NUM_CARDS - 6> unseen;
+  Hand rest = Hand::full().without(hand).without(Hand::of(upcard));
+  for (Card &c : unseen) {
+    c = rest.first();
+    rest.remove(c);
+  }
+
+  int wins = 0;
+  for (int r = 0; r < rollouts; ++r) {
+    GameState state = {};
+    state.hands[seat] = hand;
+    int next = 0;
+    for (int other = 0; other < 4; ++other) {
+      if (other == seat) {
+        continue;
+      }
+      for (int c = 0; c < 5; ++c, ++next) {
+        swap(unseen[next], unseen[next + rng.below(unseen.size() - next)]);
+        state.hands[other].add(unseen[next]);
+      }
+    }
+    if (round1) {
+      Hand &dealt = state.hands[dealer];
+      dealt.add(upcard);
+      dealt.remove(simple_discard(dealt, upcard));
+    }
+
+    state.start_hand(suit, (dealer + 1) % 4);
+    while (!state.hand_over()) {
+      const Hand held = state.hands[state.to_play()];
+      state.make_move(state.cards_in_trick() == 0
+                          ? simple_lead(held, suit)
+                          : simple_play(held, state.led(), suit));
+    }
+    wins += state.tricks[seat % 2] >= 3;
+  }
+  return double(wins) / rollouts;
+}
+
+vector<unsigned char> generate_bid_table(int rollouts, int threads,
+                                         uint64_t seed) {
+  vector<unsigned char> entries(BidTable::NUM_ENTRIES);
+  WorkStealingPool pool(threads);
+  pool.run(BidTable::NUM_HANDS, [&](int, int rank) {
+    Rng rng(seed, rank);
+    const Hand hand = BidTable::hand_at(rank);
+    for (int r = NINE; r <= ACE; ++r) {
+      const Card upcard(static_cast<Rank>(r), SPADES);
+      if (hand.contains(upcard) || canonicalize(hand, upcard).hand != hand) {
+        continue;
+      }
+      for (int position = 0; position < BidTable::NUM_POSITIONS; ++position) {
+        for (int s = SPADES; s <= DIAMONDS; ++s) {
+          const Suit suit = static_cast<Suit>(s);
+          const double p =
+              simulate_bid(hand, upcard, position, suit, rollouts, rng);
+          entries[BidTable::index(hand, upcard, position, suit)] =
+              static_cast<unsigned char>(lround(p * 255));
+        }
+      }
+    }
+  });
+  return entries;
+}
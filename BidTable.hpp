@@ -0,0 +1,96 @@
+#ifndef BID_TABLE_HPP
+#define BID_TABLE_HPP
+/* BidTable.hpp
+ *
+ * Precomputed chances of making trump for every five-card hand, upcard,
+ * bidding position and suit, generated offline and memory-mapped
+ */
+
+#include "Card.hpp"
+#include "Hand.hpp"
+#include "Random.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One byte per (hand, upcard, position, suit): the chance, out of 255, that
+// a seat holding hand takes three or more tricks with its partner after
+// making suit trump.  position is the seat's place in the bidding, 0 left
+// of the dealer through 3 for the dealer.  For the upcard's suit the entry
+// is for ordering up in round 1, with the dealer picking up; for the other
+// suits it is for calling them in round 2.
+//
+// Entries are stored for the canonical relabeling of hand and upcard only
+// (see SuitSymmetry.hpp), in which the upcard is a Spade.
+class BidTable {
+public:
+  static const int NUM_HANDS = 42504; // C(24, 5)
+  static const int NUM_UPCARDS = 6;   // Spades, Nine through Ace
+  static const int NUM_POSITIONS = 4;
+  static const size_t NUM_ENTRIES =
+      size_t(NUM_HANDS) * NUM_UPCARDS * NUM_POSITIONS * 4;
+
+  BidTable() = default;
+  BidTable(const BidTable &) = delete;
+  BidTable & operator=(const BidTable &) = delete;
+  ~BidTable();
+
+  //MODIFIES this BidTable
+  //EFFECTS Maps the table file at path read-only.  Returns false if it
+  //  cannot be opened or is not a bid table.
+  bool open(const std::string &path);
+
+  //EFFECTS Returns the open table at path, shared by the whole process, or
+  //  nullptr if it cannot be opened
+  static const BidTable * shared(const std::string &path);
+
+  //REQUIRES the table is open, hand holds five cards without upcard, and
+  //  0 <= position < NUM_POSITIONS
+  //EFFECTS Returns the chance of making suit trump, from 0 to 1
+  double win_probability(Hand hand, const Card &upcard, int position,
+                         Suit suit) const;
+
+  //EFFECTS Returns the rollouts each entry was estimated from
+  int get_rollouts() const { return rollouts; }
+
+  //REQUIRES hand holds five cards without upcard
+  //EFFECTS Returns the entry number of (hand, upcard, position, suit),
+  //  which relabelings of them share
+  static size_t index(Hand hand, const Card &upcard, int position,
+                      Suit suit);
+
+  //REQUIRES 0 <= rank < NUM_HANDS
+  //EFFECTS Returns the five-card hand numbered rank in colex order
+  static Hand hand_at(int rank);
+
+  //REQUIRES entries holds NUM_ENTRIES bytes
+  //EFFECTS Writes a table file to path.  Returns false on error.
+  static bool write(const std::string &path, int rollouts,
+                    const std::vector<unsigned char> &entries);
+
+private:
+  const unsigned char *entries = nullptr;
+  void *mapping = nullptr;
+  size_t mapping_size = 0;
+  int rollouts = 0;
+};
+
+//REQUIRES hand holds five cards without upcard, 0 <= position < 4
+//MODIFIES rng
+//EFFECTS Returns the fraction of rollouts in which the seat at position
+//  and its partner take three or more tricks after it makes suit trump.
+//  Each rollout deals the unseen cards at random and plays the hand out
+//  with the Simple strategy; in round 1 the dealer picks up the upcard.
+double simulate_bid(Hand hand, const Card &upcard, int position, Suit suit,
+                    int rollouts, Rng &rng);
+
+//REQUIRES threads >= 1
+//EFFECTS Returns every table entry, each from rollouts simulated hands.
+//  Entries for hands and upcards that are not canonical are left 0.  Hand
+//  r is simulated with Rng stream r of seed, so the result does not depend
+//  on threads.
+std::vector<unsigned char> generate_bid_table(int rollouts, int threads,
+                                              uint64_t seed);
+
+#endif // BID_TABLE_HPP
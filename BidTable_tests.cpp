@@ -0,0 +1,110 @@
+#include "BidTable.hpp"
+#include "Player.hpp"
+#include "SuitSymmetry.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace std;
+
+static const char *const TABLE_FILE = "BidTable_tests.bin";
+
+static Hand hand_of(const vector<Card> &cards) {
+  Hand hand;
+  for (const Card &c : cards) hand.add(c);
+  return hand;
+}
+
+TEST(test_bid_table_hand_ranks) {
+  Hand all_seen;
+  for (int rank = 0; rank < BidTable::NUM_HANDS; ++rank) {
+    const Hand hand = BidTable::hand_at(rank);
+    ASSERT_EQUAL(hand.size(), 5);
+    if (rank > 0) {
+      ASSERT_TRUE(hand != BidTable::hand_at(rank - 1));
+    }
+    all_seen = all_seen | hand;
+  }
+  ASSERT_TRUE(all_seen == Hand::full());
+  // Colex order ends with the five highest bits
+  ASSERT_TRUE(Hand(0xF80000u) == BidTable::hand_at(BidTable::NUM_HANDS - 1));
+}
+
+TEST(test_bid_table_index_shared_by_relabelings) {
+  const Hand hand = hand_of({Card(JACK, HEARTS), Card(QUEEN, DIAMONDS),
+                             Card(ACE, HEARTS), Card(NINE, CLUBS),
+                             Card(TEN, SPADES)});
+  const Card upcard(KING, DIAMONDS);
+  for (int n = 0; n < SuitPermutation::COUNT; ++n) {
+    const SuitPermutation p = SuitPermutation::nth(n);
+    for (int s = SPADES; s <= DIAMONDS; ++s) {
+      const Suit suit = static_cast<Suit>(s);
+      const size_t entry = BidTable::index(hand, upcard, 2, suit);
+      ASSERT_TRUE(entry < BidTable::NUM_ENTRIES);
+      ASSERT_EQUAL(BidTable::index(p(hand), p(upcard), 2, p(suit)), entry);
+    }
+  }
+}
+
+TEST(test_bid_table_write_and_map) {
+  vector<unsigned char> entries(BidTable::NUM_ENTRIES);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    entries[i] = static_cast<unsigned char>(i % 251);
+  }
+  ASSERT_TRUE(BidTable::write(TABLE_FILE, 7, entries));
+
+  BidTable table;
+  ASSERT_TRUE(table.open(TABLE_FILE));
+  ASSERT_EQUAL(table.get_rollouts(), 7);
+  const Hand hand = hand_of({Card(JACK, HEARTS), Card(JACK, DIAMONDS),
+                             Card(ACE, HEARTS), Card(NINE, CLUBS),
+                             Card(TEN, SPADES)});
+  const Card upcard(KING, HEARTS);
+  for (int position = 0; position < BidTable::NUM_POSITIONS; ++position) {
+    for (int s = SPADES; s <= DIAMONDS; ++s) {
+      const Suit suit = static_cast<Suit>(s);
+      const size_t entry = BidTable::index(hand, upcard, position, suit);
+      ASSERT_EQUAL(table.win_probability(hand, upcard, position, suit),
+                   (entry % 251) / 255.0);
+    }
+  }
+
+  ASSERT_TRUE(BidTable::shared(TABLE_FILE) != nullptr);
+  ASSERT_TRUE(BidTable::shared(TABLE_FILE) == BidTable::shared(TABLE_FILE));
+  Player *bidder = Player_factory("Ann", string("BidTable:") + TABLE_FILE);
+  ASSERT_TRUE(bidder != nullptr);
+  delete bidder;
+  remove(TABLE_FILE);
+}
+
+TEST(test_bid_table_rejects_other_files) {
+  BidTable table;
+  ASSERT_FALSE(table.open("no_such_bid_table.bin"));
+  ASSERT_FALSE(table.open("pack.in"));
+  ASSERT_TRUE(Player_factory("Ann", "BidTable:no_such_bid_table.bin")
+              == nullptr);
+}
+
+TEST(test_simulate_bid_strength) {
+  Rng rng(1);
+  const Card upcard(NINE, HEARTS);
+  const Hand strong = hand_of({Card(JACK, HEARTS), Card(JACK, DIAMONDS),
+                               Card(ACE, HEARTS), Card(KING, HEARTS),
+                               Card(ACE, CLUBS)});
+  const Hand weak = hand_of({Card(NINE, SPADES), Card(TEN, SPADES),
+                             Card(NINE, CLUBS), Card(TEN, CLUBS),
+                             Card(NINE, DIAMONDS)});
+  ASSERT_TRUE(simulate_bid(strong, upcard, 0, HEARTS, 200, rng) > 0.9);
+  ASSERT_TRUE(simulate_bid(weak, upcard, 0, HEARTS, 200, rng) < 0.3);
+
+  // The dealer picks up the right bower; left of the dealer gives it away
+  const Card bower(JACK, HEARTS);
+  const Hand aces = hand_of({Card(ACE, HEARTS), Card(KING, HEARTS),
+                             Card(ACE, SPADES), Card(NINE, CLUBS),
+                             Card(NINE, DIAMONDS)});
+  ASSERT_TRUE(simulate_bid(aces, bower, 3, HEARTS, 200, rng)
+              > simulate_bid(aces, bower, 0, HEARTS, 200, rng) + 0.2);
+}
+
+TEST_MAIN()
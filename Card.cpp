@@ -91,51 +91,14 @@ std::istream & operator>>(std::istream &is, Suit &suit) {
   return is;
 }
 
-/////////////// Write your implementation for Card below ///////////////
-
-// Default constructor
-Card::Card() : rank(TWO), suit(SPADES) {}
-
-// Constructor with parameters
-Card::Card(Rank rank_in, Suit suit_in) : rank(rank_in), suit(suit_in) {}
-
-// Return rank
-Rank Card::get_rank() const {
-    return rank;
-}
-
-// Return suit (no trump)
-Suit Card::get_suit() const {
-    return suit;
-}
-
-// Return suit (with trump consideration)
-Suit Card::get_suit(Suit trump) const {
-    if (is_left_bower(trump)) {
-        return trump;
-    }
-    return suit;
-}
-
-// True if card is face card or ace
-bool Card::is_face_or_ace() const {
-    return rank == JACK || rank == QUEEN || rank == KING || rank == ACE;
+const char * Suit_name(Suit suit) {
+  return SUIT_NAMES[suit];
 }
 
-// True if card is right bower (Jack of trump)
-bool Card::is_right_bower(Suit trump) const {
-    return rank == JACK && suit == trump;
-}
-
-// True if card is left bower (Jack of same color as trump)
-bool Card::is_left_bower(Suit trump) const {
-    return rank == JACK && suit == Suit_next(trump);
-}
+/////////////// Write your implementation for Card below ///////////////
 
-// True if card is trump (includes left bower)
-bool Card::is_trump(Suit trump) const {
-    return suit == trump || is_left_bower(trump);
-}
+// Constructors, accessors, comparison operators and Suit_next are
+// constexpr and defined inline in Card.hpp.
 
 // Print card
 std::ostream & operator<<(std::ostream &os, const Card &card) {
@@ -143,109 +106,107 @@ std::ostream & operator<<(std::ostream &os, const Card &card) {
     return os;
 }
 
+const std::string & Card_name(const Card &card) {
+  static const array<string, Card::NUM_INDICES> names = [] {
+    array<string, Card::NUM_INDICES> built;
+    for (int i = 0; i < Card::NUM_INDICES; ++i) {
+      const Card c = Card::from_index(i);
+      built[i] = string(RANK_NAMES[c.get_rank()]) + " of "
+                 + SUIT_NAMES[c.get_suit()];
+    }
+    return built;
+  }();
+  return names[card.get_index()];
+}
+
 // Read card
 std::istream & operator>>(std::istream &is, Card &card) {
     std::string rank_str, of_str, suit_str;
     if (is >> rank_str >> of_str >> suit_str) {
-        card.rank= string_to_rank(rank_str);
-        card.suit = string_to_suit(suit_str);
+        card = Card(string_to_rank(rank_str), string_to_suit(suit_str));
     }
     return is;
 }
 
-// Comparison operators (no trump considered)
-bool operator<(const Card &lhs, const Card &rhs) {
-    if (lhs.get_rank() != rhs.get_rank()) return lhs.get_rank() < rhs.get_rank();
-    return lhs.get_suit() < rhs.get_suit();
-}
-
-bool operator<=(const Card &lhs, const Card &rhs) {
-    return (lhs < rhs) || (lhs == rhs);
-}
-
-
-bool operator>(const Card &lhs, const Card &rhs) {
-    if (lhs.get_rank() != rhs.get_rank()) return lhs.get_rank() > rhs.get_rank();
-    return lhs.get_suit() > rhs.get_suit();
+// Power ordinals used by Card_less.  Card indices already follow operator<
+// (rank, then suit).  Each table maps a card index to a byte whose integer
+// order is the trump-aware card order, which turns every Card_less call into
+// two loads and a compare.
+static const int NUM_CARD_INDICES = Card::NUM_INDICES;
+static const int NUM_SUITS = DIAMONDS + 1;
+
+using PowerRow = std::array<unsigned char, NUM_CARD_INDICES>;
+
+// Non-trump cards keep their index, trump cards are lifted above every
+// non-trump card, and the bowers sit at the very top.
+static constexpr PowerRow make_trump_powers(int trump) {
+    PowerRow row{};
+    const int next = Suit_next(static_cast<Suit>(trump));
+    for (int i = 0; i < NUM_CARD_INDICES; ++i) {
+        const int rank = i / NUM_SUITS;
+        const int suit = i % NUM_SUITS;
+        int power = i;
+        if (rank == JACK && suit == trump) {
+            power = 2 * NUM_CARD_INDICES + 1;
+        } else if (rank == JACK && suit == next) {
+            power = 2 * NUM_CARD_INDICES;
+        } else if (suit == trump) {
+            power = NUM_CARD_INDICES + i;
+        }
+        row[i] = static_cast<unsigned char>(power);
+    }
+    return row;
 }
 
-bool operator>=(const Card &lhs, const Card &rhs) {
-    return (lhs > rhs) || (lhs == rhs);
+// Same as make_trump_powers, with an extra band for cards following the led
+// suit that sits between plain cards and trump.
+static constexpr PowerRow make_led_powers(int trump, int led) {
+    PowerRow row = make_trump_powers(trump);
+    for (int i = 0; i < NUM_CARD_INDICES; ++i) {
+        const bool is_trump = row[i] >= NUM_CARD_INDICES;
+        if (is_trump || i % NUM_SUITS == led) {
+            row[i] = static_cast<unsigned char>(row[i] + NUM_CARD_INDICES);
+        }
+    }
+    return row;
 }
 
-bool operator==(const Card &lhs, const Card &rhs) {
-    return lhs.get_rank() == rhs.get_rank() && lhs.get_suit() == rhs.get_suit();
+static constexpr std::array<PowerRow, NUM_SUITS> make_trump_table() {
+    std::array<PowerRow, NUM_SUITS> table{};
+    for (int t = 0; t < NUM_SUITS; ++t) {
+        table[t] = make_trump_powers(t);
+    }
+    return table;
 }
 
-bool operator!=(const Card &lhs, const Card &rhs) {
-    return !(lhs == rhs);
+// Indexed by [trump][led suit][card index].  The led suit is the effective
+// suit of the led card, so a led left bower selects the trump row.
+static constexpr std::array<std::array<PowerRow, NUM_SUITS>, NUM_SUITS>
+make_led_table() {
+    std::array<std::array<PowerRow, NUM_SUITS>, NUM_SUITS> table{};
+    for (int t = 0; t < NUM_SUITS; ++t) {
+        for (int led = 0; led < NUM_SUITS; ++led) {
+            table[t][led] = make_led_powers(t, led);
+        }
+    }
+    return table;
 }
 
-// Returns the next suit of the same color
-Suit Suit_next(Suit suit) {
-    if (suit == SPADES) return CLUBS;      // same color (black)
-    if (suit == CLUBS) return SPADES;      // same color (black)
-    if (suit == HEARTS) return DIAMONDS;   // same color (red)
-    if (suit == DIAMONDS) return HEARTS;   // same color (red)
-    assert(false);
-    return SPADES; // default
-}
+static constexpr std::array<PowerRow, NUM_SUITS> TRUMP_POWER
+    = make_trump_table();
+static constexpr std::array<std::array<PowerRow, NUM_SUITS>, NUM_SUITS>
+    LED_POWER = make_led_table();
 
 // Compare cards when only trump suit is known
 bool Card_less(const Card &a, const Card &b, Suit trump) {
-    // Right and left bowers
-    bool a_right = a.is_right_bower(trump);
-    bool b_right = b.is_right_bower(trump);
-    bool a_left = a.is_left_bower(trump);
-    bool b_left = b.is_left_bower(trump);
-
-    // Right bower beats everything
-    if (a_right && !b_right) return false;
-    if (!a_right && b_right) return true;
-
-    // Left bower beats all except right bower
-    if (a_left && !b_left) return false;
-    if (!a_left && b_left) return true;
-
-    // If both are trump
-    if (a.is_trump(trump) && b.is_trump(trump)) {
-        return a.get_rank() < b.get_rank();
-    }
-
-    // If only one is trump
-    if (a.is_trump(trump) && !b.is_trump(trump)) return false;
-    if (!a.is_trump(trump) && b.is_trump(trump)) return true;
-
-    // Neither is trump — compare by rank
-    return a.get_rank() < b.get_rank();
+    const PowerRow &power = TRUMP_POWER[trump];
+    return power[a.get_index()] < power[b.get_index()];
 }
 
 // Compare cards when both trump and led card are known
 bool Card_less(const Card &a, const Card &b, const Card &led_card, Suit trump) {
-    Suit led_suit = led_card.get_suit(trump);
-    bool a_follows = a.get_suit(trump) == led_suit;
-    bool b_follows = b.get_suit(trump) == led_suit;
-
-    // If exactly one follows led, that one is higher unless the other is trump
-    if (a_follows && !b_follows) {
-        if (b.is_trump(trump)) {
-            // b is trump; a < b
-            return true;
-        }
-        // a follows, b does not and is not trump; a > b
-        return false;
-    }
-    if (!a_follows && b_follows) {
-        if (a.is_trump(trump)) {
-            // a is trump; a > b
-            return false;
-        }
-        // b follows, a does not and is not trump; a < b
-        return true;
-    }
-
-    // Both follow led OR neither follows led: compare using trump-aware order
-    return Card_less(a, b, trump);
+    const PowerRow &power = LED_POWER[trump][led_card.get_suit(trump)];
+    return power[a.get_index()] < power[b.get_index()];
 }
 
 // NOTE: We HIGHLY recommend you check out the operator overloading
@@ -72,51 +72,75 @@ std::ostream & operator<<(std::ostream &os, Suit suit);
 //EFFECTS Reads a Suit from a stream, for example "Spades" -> SPADES
 std::istream & operator>>(std::istream &is, Suit &suit);
 
+//EFFECTS Returns the name operator<< prints for suit, for example "Spades"
+const char * Suit_name(Suit suit);
 
+
+//EFFECTS returns the next suit, which is the suit of the same color
+constexpr Suit Suit_next(Suit suit);
+
+
+// A Card is stored in a single byte holding its index, rank * 4 + suit.
+// Index order is the same as operator< (rank first, then suit), so the
+// comparison operators are plain integer compares.
 class Card {
 public:
+  // Number of distinct card indices, one per rank/suit pair
+  static const int NUM_INDICES = (ACE + 1) * (DIAMONDS + 1);
 
   //EFFECTS Initializes Card to the Two of Spades
-  Card();
+  constexpr Card();
 
   //EFFECTS Initializes Card to specified rank and suit
-  Card(Rank rank_in, Suit suit_in);
+  constexpr Card(Rank rank_in, Suit suit_in);
+
+  //REQUIRES 0 <= index < NUM_INDICES
+  //EFFECTS Returns the Card whose get_index() is index
+  static constexpr Card from_index(int index);
+
+  //EFFECTS Returns rank * 4 + suit, a dense index in [0, NUM_INDICES)
+  constexpr int get_index() const;
 
   //EFFECTS Returns the rank
-  Rank get_rank() const;
+  constexpr Rank get_rank() const;
 
   //EFFECTS Returns the suit.  Does not consider trump.
-  Suit get_suit() const;
+  constexpr Suit get_suit() const;
 
   //EFFECTS Returns the suit
   //HINT: the left bower is the trump suit!
-  Suit get_suit(Suit trump) const;
+  constexpr Suit get_suit(Suit trump) const;
 
   //EFFECTS Returns true if card is a face card (Jack, Queen, King or Ace)
-  bool is_face_or_ace() const;
+  constexpr bool is_face_or_ace() const;
 
   //EFFECTS Returns true if card is the Jack of the trump suit
-  bool is_right_bower(Suit trump) const;
+  constexpr bool is_right_bower(Suit trump) const;
 
   //EFFECTS Returns true if card is the Jack of the next suit
-  bool is_left_bower(Suit trump) const;
+  constexpr bool is_left_bower(Suit trump) const;
 
   //EFFECTS Returns true if the card is a trump card.  All cards of the trump
   // suit are trump cards.  The left bower is also a trump card.
-  bool is_trump(Suit trump) const;
+  constexpr bool is_trump(Suit trump) const;
 
 private:
-  Rank rank;
-  Suit suit;
+  unsigned char index;
 
   // This "friend declaration" allows the implementation of operator>>
   // to access private member variables of the Card class.
   friend std::istream & operator>>(std::istream &is, Card &card);
 };
 
+static_assert(sizeof(Card) == 1, "Card must pack into one byte");
+
 //EFFECTS Prints Card to stream, for example "Two of Spades"
 std::ostream & operator<<(std::ostream &os, const Card &card);
 
+//EFFECTS Returns the name operator<< prints for card, for example "Two of
+//  Spades", from a table built once
+const std::string & Card_name(const Card &card);
+
 //EFFECTS Reads a Card from a stream in the format "Two of Spades"
 //NOTE The Card class declares this operator>> "friend" function,
 //     which means it is allowed to access card.rank and card.suit.
@@ -124,30 +148,27 @@ std::istream & operator>>(std::istream &is, Card &card);
 
 //EFFECTS Returns true if lhs is lower value than rhs.
 //  Does not consider trump.
-bool operator<(const Card &lhs, const Card &rhs);
+constexpr bool operator<(const Card &lhs, const Card &rhs);
 
 //EFFECTS Returns true if lhs is lower value than rhs or the same card as rhs.
 //  Does not consider trump.
-bool operator<=(const Card &lhs, const Card &rhs);
+constexpr bool operator<=(const Card &lhs, const Card &rhs);
 
 //EFFECTS Returns true if lhs is higher value than rhs.
 //  Does not consider trump.
-bool operator>(const Card &lhs, const Card &rhs);
+constexpr bool operator>(const Card &lhs, const Card &rhs);
 
 //EFFECTS Returns true if lhs is higher value than rhs or the same card as rhs.
 //  Does not consider trump.
-bool operator>=(const Card &lhs, const Card &rhs);
+constexpr bool operator>=(const Card &lhs, const Card &rhs);
 
 //EFFECTS Returns true if lhs is same card as rhs.
 //  Does not consider trump.
-bool operator==(const Card &lhs, const Card &rhs);
+constexpr bool operator==(const Card &lhs, const Card &rhs);
 
 //EFFECTS Returns true if lhs is not the same card as rhs.
 //  Does not consider trump.
-bool operator!=(const Card &lhs, const Card &rhs);
-
-//EFFECTS returns the next suit, which is the suit of the same color
-Suit Suit_next(Suit suit);
+constexpr bool operator!=(const Card &lhs, const Card &rhs);
 
 //EFFECTS Returns true if a is lower value than b.  Uses trump to determine
 // order, as described in the spec.
@@ -157,4 +178,77 @@ bool Card_less(const Card &a, const Card &b, Suit trump);
 //  and the suit led to determine order, as described in the spec.
 bool Card_less(const Card &a, const Card &b, const Card &led_card, Suit trump);
 
+/////////////// Inline definitions ///////////////
+
+// Suits of the same color differ only in their second bit
+constexpr Suit Suit_next(Suit suit) {
+  return static_cast<Suit>(suit ^ 2);
+}
+
+constexpr Card::Card() : index(0) {}
+
+constexpr Card::Card(Rank rank_in, Suit suit_in)
+  : index(static_cast<unsigned char>(rank_in * (DIAMONDS + 1) + suit_in)) {}
+
+constexpr Card Card::from_index(int index) {
+  return Card(static_cast<Rank>(index / (DIAMONDS + 1)),
+              static_cast<Suit>(index % (DIAMONDS + 1)));
+}
+
+constexpr int Card::get_index() const {
+  return index;
+}
+
+constexpr Rank Card::get_rank() const {
+  return static_cast<Rank>(index / (DIAMONDS + 1));
+}
+
+constexpr Suit Card::get_suit() const {
+  return static_cast<Suit>(index % (DIAMONDS + 1));
+}
+
+constexpr Suit Card::get_suit(Suit trump) const {
+  return is_left_bower(trump) ? trump : get_suit();
+}
+
+constexpr bool Card::is_face_or_ace() const {
+  return get_rank() >= JACK;
+}
+
+constexpr bool Card::is_right_bower(Suit trump) const {
+  return *this == Card(JACK, trump);
+}
+
+constexpr bool Card::is_left_bower(Suit trump) const {
+  return *this == Card(JACK, Suit_next(trump));
+}
+
+constexpr bool Card::is_trump(Suit trump) const {
+  return get_suit(trump) == trump;
+}
+
+constexpr bool operator<(const Card &lhs, const Card &rhs) {
+  return lhs.get_index() < rhs.get_index();
+}
+
+constexpr bool operator<=(const Card &lhs, const Card &rhs) {
+  return lhs.get_index() <= rhs.get_index();
+}
+
+constexpr bool operator>(const Card &lhs, const Card &rhs) {
+  return lhs.get_index() > rhs.get_index();
+}
+
+constexpr bool operator>=(const Card &lhs, const Card &rhs) {
+  return lhs.get_index() >= rhs.get_index();
+}
+
+constexpr bool operator==(const Card &lhs, const Card &rhs) {
+  return lhs.get_index() == rhs.get_index();
+}
+
+constexpr bool operator!=(const Card &lhs, const Card &rhs) {
+  return lhs.get_index() != rhs.get_index();
+}
+
 #endif // CARD_HPP
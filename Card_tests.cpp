@@ -1,6 +1,7 @@
 #include "Card.hpp"
 #include "unit_test_framework.hpp"
 #include <iostream>
+#include <sstream>
 
 using namespace std;
 
@@ -141,4 +142,41 @@ TEST(test_card_comparisons_led_context) {
     ASSERT_FALSE(Card_less(trump_jack, led_ace, led_ace, trump));
 }
 
+TEST(test_card_less_suit_tiebreak) {
+    Suit trump = DIAMONDS;
+    Card nine_spades(NINE, SPADES);
+    Card nine_clubs(NINE, CLUBS);
+    Card nine_hearts(NINE, HEARTS);
+
+    // Equal-rank non-trump cards fall back to suit order
+    ASSERT_TRUE(Card_less(nine_spades, nine_clubs, trump));
+    ASSERT_FALSE(Card_less(nine_clubs, nine_spades, trump));
+    ASSERT_TRUE(Card_less(nine_spades, nine_hearts, nine_clubs, trump));
+    // Following the led suit still beats a higher suit
+    ASSERT_TRUE(Card_less(nine_hearts, nine_spades, nine_spades, trump));
+}
+
+TEST(test_card_index_round_trip) {
+    static_assert(Suit_next(HEARTS) == DIAMONDS, "Suit_next is constexpr");
+    static_assert(Card(JACK, CLUBS).is_left_bower(SPADES),
+                  "is_left_bower is constexpr");
+    for (int i = 0; i < Card::NUM_INDICES; ++i) {
+        Card c = Card::from_index(i);
+        ASSERT_EQUAL(c.get_index(), i);
+        ASSERT_EQUAL(c, Card(c.get_rank(), c.get_suit()));
+    }
+    ASSERT_TRUE(Card(ACE, SPADES) < Card(ACE, HEARTS));
+    ASSERT_TRUE(Card(KING, DIAMONDS) < Card(ACE, SPADES));
+}
+
+TEST(test_card_and_suit_names) {
+    for (int i = 0; i < Card::NUM_INDICES; ++i) {
+        const Card c = Card::from_index(i);
+        ostringstream printed;
+        printed << c;
+        ASSERT_EQUAL(Card_name(c), printed.str());
+    }
+    ASSERT_EQUAL(string(Suit_name(DIAMONDS)), "Diamonds");
+}
+
 TEST_MAIN()
@@ -0,0 +1,319 @@
+// EndgameTable.cpp
+#include "EndgameTable.hpp"
+#include "WorkStealing.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// A table file is this header followed by its packed sections
+struct EndgameTableHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t tricks;
+};
+
+static const char MAGIC[8] = {'E', 'U', 'C', 'H', 'R', 'E', 'E', 'G'};
+static const uint32_t VERSION = 1;
+
+// Entries per byte, and bits per entry
+static const int PER_BYTE = 4;
+static const int ENTRY_BITS = 2;
+
+static const int MAX_CARDS = 4 * EndgameTable::MAX_TRICKS;
+
+static constexpr array<uint64_t, MAX_CARDS + 1> make_factorials() {
+  array<uint64_t, MAX_CARDS + 1> f = {};
+  f[0] = 1;
+  for (int n = 1; n <= MAX_CARDS; ++n) {
+    f[n] = f[n - 1] * n;
+  }
+  return f;
+}
+
+static constexpr array<uint64_t, MAX_CARDS + 1> FACTORIAL = make_factorials();
+
+// SPLITS[cards][suits] is the number of ways to split cards among suits
+static constexpr array<array<uint32_t, 5>, MAX_CARDS + 1> make_splits() {
+  array<array<uint32_t, 5>, MAX_CARDS + 1> s = {};
+  for (int cards = 0; cards <= MAX_CARDS; ++cards) {
+    s[cards][1] = 1;
+    for (int suits = 2; suits <= 4; ++suits) {
+      for (int first = 0; first <= cards; ++first) {
+        s[cards][suits] += s[cards - first][suits - 1];
+      }
+    }
+  }
+  return s;
+}
+
+static constexpr array<array<uint32_t, 5>, MAX_CARDS + 1> SPLITS =
+    make_splits();
+
+// ORDERS[counts] is the number of orders of the seats holding cards when
+// seat i holds counts[i], with the four counts packed two bits each
+static constexpr array<uint32_t, 256> make_orders() {
+  array<uint32_t, 256> orders = {};
+  for (int packed = 0; packed < 256; ++packed) {
+    uint64_t ways = FACTORIAL[(packed & 3) + (packed >> 2 & 3)
+                             + (packed >> 4 & 3) + (packed >> 6 & 3)];
+    for (int seat = 0; seat < 4; ++seat) {
+      ways /= FACTORIAL[packed >> (2 * seat) & 3];
+    }
+    orders[packed] = static_cast<uint32_t>(ways);
+  }
+  return orders;
+}
+
+static constexpr array<uint32_t, 256> ORDERS = make_orders();
+static_assert(EndgameTable::MAX_TRICKS <= 3, "counts are packed in 2 bits");
+
+// Counts of tricks_left for every seat, packed as ORDERS indexes them
+static int all_seats(int tricks_left) {
+  return tricks_left * 0x55;
+}
+
+// The suits in table order when trump is trump
+static array<Suit, 4> suits_in_order(Suit trump) {
+  array<Suit, 4> suits = {{trump, Suit_next(trump), SPADES, SPADES}};
+  int next = 2;
+  for (int s = SPADES; s <= DIAMONDS; ++s) {
+    if (s != trump && s != Suit_next(trump)) {
+      suits[next++] = static_cast<Suit>(s);
+    }
+  }
+  return suits;
+}
+
+// Bytes before the section for tricks_left tricks left, for 1 through
+// MAX_TRICKS + 1
+static size_t section_offset(int tricks_left) {
+  size_t offset = 0;
+  for (int t = 1; t < tricks_left; ++t) {
+    offset += (EndgameTable::num_entries(t) + PER_BYTE - 1) / PER_BYTE;
+  }
+  return offset;
+}
+
+static const array<size_t, EndgameTable::MAX_TRICKS + 2> SECTION_OFFSET = {{
+  0, section_offset(1), section_offset(2), section_offset(3), section_offset(4)
+}};
+
+EndgameTable::~EndgameTable() {
+  if (mapping) {
+    munmap(mapping, mapping_size);
+  }
+}
+
+bool EndgameTable::open(const string &path) {
+  assert(!mapping);
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  void *base = MAP_FAILED;
+  const size_t size = fstat(fd, &st) == 0 ? st.st_size : 0;
+  if (size >= sizeof(EndgameTableHeader)) {
+    base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  ::close(fd);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+
+  EndgameTableHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+      || header.version != VERSION || header.tricks < 1
+      || header.tricks > MAX_TRICKS
+      || size != sizeof(header) + SECTION_OFFSET[header.tricks + 1]) {
+    munmap(base, size);
+    return false;
+  }
+  mapping = base;
+  mapping_size = size;
+  entries = static_cast<const unsigned char *>(base) + sizeof(header);
+  tricks = header.tricks;
+  return true;
+}
+
+const EndgameTable * EndgameTable::shared(const string &path) {
+  static mutex lock;
+  static map<string, unique_ptr<EndgameTable>> tables;
+  lock_guard<mutex> guard(lock);
+  auto found = tables.find(path);
+  if (found == tables.end()) {
+    unique_ptr<EndgameTable> table(new EndgameTable());
+    if (!table->open(path)) {
+      table.reset();
+    }
+    found = tables.emplace(path, std::move(table)).first;
+  }
+  return found->second.get();
+}
+
+int EndgameTable::team0_tricks(const Position &pos) const {
+  assert(entries);
+  const int tricks_left = pos.hands[pos.leader].size();
+  assert(pos.played == 0 && 1 <= tricks_left && tricks_left <= tricks);
+  const size_t i = index(pos);
+  const unsigned char byte = entries[SECTION_OFFSET[tricks_left] + i / PER_BYTE];
+  const int leaders = byte >> (i % PER_BYTE * ENTRY_BITS) & 3;
+  return pos.leader % 2 == 0 ? leaders : tricks_left - leaders;
+}
+
+size_t EndgameTable::num_entries(int tricks_left) {
+  assert(1 <= tricks_left && tricks_left <= MAX_TRICKS);
+  return size_t(SPLITS[4 * tricks_left][4]) * ORDERS[all_seats(tricks_left)];
+}
+
+size_t EndgameTable::index(const Position &pos) {
+  assert(pos.played == 0);
+  const int tricks_left = pos.hands[pos.leader].size();
+  const Suit trump = pos.trump;
+  // Each seat's cards, numbering seats from the leader
+  array<uint32_t, 4> held;
+  for (int seat = 0; seat < 4; ++seat) {
+    held[seat] = pos.hands[(pos.leader + seat) % 4].get_bits();
+  }
+  const uint32_t all = held[0] | held[1] | held[2] | held[3];
+  const uint32_t right = Hand::of(Card(JACK, trump)).get_bits();
+  const uint32_t left = Hand::of(Card(JACK, Suit_next(trump))).get_bits();
+
+  // Rank the split among suits, and list the seats holding each suit's
+  // cards from highest to lowest.  Apart from the bowers, a higher card of
+  // a suit is a higher bit.
+  const array<Suit, 4> suits = suits_in_order(trump);
+  size_t split = 0;
+  int cards_left = 4 * tricks_left;
+  array<int, MAX_CARDS> seats;
+  int n = 0;
+  for (int i = 0; i < 4; ++i) {
+    uint32_t suit = all & Hand::suit_cards(suits[i], trump).get_bits();
+    const int count = __builtin_popcount(suit);
+    for (int fewer = 0; i < 3 && fewer < count; ++fewer) {
+      split += SPLITS[cards_left - fewer][3 - i];
+    }
+    cards_left -= count;
+    while (suit) {
+      uint32_t card = uint32_t(1) << (31 - __builtin_clz(suit));
+      if (i == 0 && (suit & (right | left))) {
+        card = suit & right ? right : left;
+      }
+      suit &= ~card;
+      seats[n++] = !!(held[1] & card) + 2 * !!(held[2] & card)
+                   + 3 * !!(held[3] & card);
+    }
+  }
+
+  // Rank the order of the seats among all orders with the same counts
+  int counts = all_seats(tricks_left);
+  uint64_t order = 0;
+  for (int i = 0; i < n; ++i) {
+    for (int seat = 0; seat < seats[i]; ++seat) {
+      const int one = 1 << (2 * seat);
+      if (counts & (3 * one)) {
+        order += ORDERS[counts - one];
+      }
+    }
+    counts -= 1 << (2 * seats[i]);
+  }
+  return split * ORDERS[all_seats(tricks_left)] + order;
+}
+
+bool EndgameTable::write(const string &path, int tricks_in,
+                         const vector<unsigned char> &entries) {
+  assert(1 <= tricks_in && tricks_in <= MAX_TRICKS);
+  assert(entries.size() == SECTION_OFFSET[tricks_in + 1]);
+  EndgameTableHeader header;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.tricks = tricks_in;
+  ofstream out(path, ios::binary);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char *>(entries.data()), entries.size());
+  return bool(out);
+}
+
+// Solves every shape with tricks_left tricks left into section, one split
+// among suits per task.  Each split's entries fill whole bytes, so tasks
+// never write the same byte.
+static void generate_section(int tricks_left, int threads,
+                             unsigned char *section) {
+  const Suit trump = SPADES;
+  const array<Suit, 4> suits = suits_in_order(trump);
+  array<array<Card, 7>, 4> cards; // each suit's cards, highest first
+  array<int, 4> sizes;
+  for (int i = 0; i < 4; ++i) {
+    Hand suit = Hand::suit_cards(suits[i], trump);
+    sizes[i] = suit.size();
+    for (int j = 0; !suit.empty(); ++j) {
+      cards[i][j] = suit.highest(trump);
+      suit.remove(cards[i][j]);
+    }
+  }
+
+  const int total = 4 * tricks_left;
+  vector<array<int, 4>> splits;
+  for (int a = 0; a <= total; ++a) {
+    for (int b = 0; a + b <= total; ++b) {
+      for (int c = 0; a + b + c <= total; ++c) {
+        splits.push_back({{a, b, c, total - a - b - c}});
+      }
+    }
+  }
+  assert(splits.size() == SPLITS[total][4]);
+  const uint64_t orders = ORDERS[all_seats(tricks_left)];
+  assert(orders % PER_BYTE == 0);
+
+  vector<DoubleDummySolver> solvers(threads);
+  WorkStealingPool pool(threads);
+  pool.run(splits.size(), [&](int worker, int s) {
+    const array<int, 4> &split = splits[s];
+    for (int i = 0; i < 4; ++i) {
+      if (split[i] > sizes[i]) {
+        return;
+      }
+    }
+    array<int, MAX_CARDS> seats;
+    for (int i = 0; i < total; ++i) {
+      seats[i] = i / tricks_left;
+    }
+    size_t entry = s * orders;
+    do {
+      Position pos;
+      pos.trump = trump;
+      pos.leader = 0;
+      int n = 0;
+      for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < split[i]; ++j) {
+          pos.hands[seats[n++]].add(cards[i][j]);
+        }
+      }
+      assert(EndgameTable::index(pos) == entry);
+      const int leaders = solvers[worker].team0_tricks(pos);
+      section[entry / PER_BYTE] |= leaders << (entry % PER_BYTE * ENTRY_BITS);
+      ++entry;
+    } while (next_permutation(seats.begin(), seats.begin() + total));
+  });
+}
+
+vector<unsigned char> generate_endgame_table(int tricks, int threads) {
+  assert(1 <= tricks && tricks <= EndgameTable::MAX_TRICKS);
+  vector<unsigned char> entries(SECTION_OFFSET[tricks + 1]);
+  for (int t = 1; t <= tricks; ++t) {
+    generate_section(t, threads, entries.data() + SECTION_OFFSET[t]);
+  }
+  return entries;
+}
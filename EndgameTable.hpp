@@ -0,0 +1,76 @@
+#ifndef ENDGAME_TABLE_HPP
+#define ENDGAME_TABLE_HPP
+/* EndgameTable.hpp
+ *
+ * Exact double-dummy results for the last tricks of a hand, generated
+ * offline and memory-mapped
+ */
+
+#include "Solver.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// A position at a trick boundary is looked up by its shape alone.  Seats
+// are numbered from the leader, and each suit, counting the left bower as
+// trump, is reduced to the seats holding its remaining cards from highest
+// to lowest.  The suits go trump, Suit_next(trump), then the other two in
+// Suit order.  Which cards remain, and which suit is trump, do not change
+// who wins what, so positions with the same shape share one entry.
+//
+// An entry is the tricks the leader's team takes, two bits each.  The file
+// holds a section for every number of tricks left from 1 to get_tricks().
+class EndgameTable {
+public:
+  static const int MAX_TRICKS = 3;
+
+  EndgameTable() = default;
+  EndgameTable(const EndgameTable &) = delete;
+  EndgameTable & operator=(const EndgameTable &) = delete;
+  ~EndgameTable();
+
+  //MODIFIES this EndgameTable
+  //EFFECTS Maps the table file at path read-only.  Returns false if it
+  //  cannot be opened or is not an endgame table.
+  bool open(const std::string &path);
+
+  //EFFECTS Returns the open table at path, shared by the whole process, or
+  //  nullptr if it cannot be opened
+  static const EndgameTable * shared(const std::string &path);
+
+  //EFFECTS Returns the most tricks left that the table covers
+  int get_tricks() const { return tricks; }
+
+  //REQUIRES the table is open, pos is at a trick boundary, and every hand
+  //  holds between 1 and get_tricks() cards, the same number
+  //EFFECTS Returns the tricks team 0 takes from pos with perfect play
+  int team0_tricks(const Position &pos) const;
+
+  //REQUIRES 1 <= tricks_left <= MAX_TRICKS
+  //EFFECTS Returns the number of entries for positions with tricks_left
+  //  tricks left
+  static size_t num_entries(int tricks_left);
+
+  //REQUIRES pos is as for team0_tricks
+  //EFFECTS Returns the entry number of pos within its section
+  static size_t index(const Position &pos);
+
+  //REQUIRES 1 <= tricks_in <= MAX_TRICKS, and entries holds every section
+  //  up to tricks_in packed as generate_endgame_table returns them
+  //EFFECTS Writes a table file to path.  Returns false on error.
+  static bool write(const std::string &path, int tricks_in,
+                    const std::vector<unsigned char> &entries);
+
+private:
+  const unsigned char *entries = nullptr;
+  void *mapping = nullptr;
+  size_t mapping_size = 0;
+  int tricks = 0;
+};
+
+//REQUIRES 1 <= tricks <= EndgameTable::MAX_TRICKS, threads >= 1
+//EFFECTS Returns the packed sections for 1 through tricks tricks left,
+//  each solved exactly.  Shapes no deal can reach are left 0.
+std::vector<unsigned char> generate_endgame_table(int tricks, int threads);
+
+#endif // ENDGAME_TABLE_HPP
@@ -0,0 +1,117 @@
+#include "EndgameTable.hpp"
+#include "Pack.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdio>
+#include <set>
+
+using namespace std;
+
+static const char *const TABLE_FILE = "EndgameTable_tests.bin";
+
+// Deals cards_each cards to every seat from a random shuffle
+static array<Hand, 4> random_deal(Rng &rng, int cards_each) {
+  Pack pack;
+  pack.shuffle(rng);
+  array<Hand, 4> hands;
+  for (int seat = 0; seat < 4; ++seat) {
+    for (int c = 0; c < cards_each; ++c) {
+      hands[seat].add(pack.deal_one());
+    }
+  }
+  return hands;
+}
+
+static Position random_position(Rng &rng, int tricks_left) {
+  Position pos;
+  pos.hands = random_deal(rng, tricks_left);
+  pos.trump = static_cast<Suit>(rng.below(4));
+  pos.leader = rng.below(4);
+  return pos;
+}
+
+TEST(test_endgame_num_entries) {
+  // Splits of 4n cards among four suits, times orders of the seats
+  ASSERT_EQUAL(EndgameTable::num_entries(1), size_t(35 * 24));
+  ASSERT_EQUAL(EndgameTable::num_entries(2), size_t(165 * 2520));
+  ASSERT_EQUAL(EndgameTable::num_entries(3), size_t(455) * 369600);
+}
+
+TEST(test_endgame_index_ignores_card_and_suit_names) {
+  // Seat 0 leads the best trump and the best Club against low cards
+  Position pos;
+  pos.hands = {{Hand::of(Card(JACK, HEARTS)) | Hand::of(Card(ACE, CLUBS)),
+                Hand::of(Card(NINE, HEARTS)) | Hand::of(Card(NINE, CLUBS)),
+                Hand::of(Card(TEN, HEARTS)) | Hand::of(Card(TEN, CLUBS)),
+                Hand::of(Card(QUEEN, HEARTS)) | Hand::of(Card(KING, CLUBS))}};
+  pos.trump = HEARTS;
+  pos.leader = 0;
+
+  // The same shape with Spades trump, other cards, and seats rotated
+  Position same;
+  same.hands = {{Hand::of(Card(ACE, SPADES)) | Hand::of(Card(JACK, DIAMONDS)),
+                 Hand::of(Card(JACK, SPADES)) | Hand::of(Card(ACE, DIAMONDS)),
+                 Hand::of(Card(NINE, SPADES)) | Hand::of(Card(NINE, DIAMONDS)),
+                 Hand::of(Card(TEN, SPADES)) | Hand::of(Card(TEN, DIAMONDS))}};
+  same.trump = SPADES;
+  same.leader = 1;
+  ASSERT_EQUAL(EndgameTable::index(pos), EndgameTable::index(same));
+
+  Position other = same;
+  other.leader = 2;
+  ASSERT_NOT_EQUAL(EndgameTable::index(other), EndgameTable::index(same));
+}
+
+TEST(test_endgame_index_in_range) {
+  Rng rng(5);
+  for (int tricks_left = 1; tricks_left <= EndgameTable::MAX_TRICKS;
+       ++tricks_left) {
+    set<size_t> seen;
+    for (int trial = 0; trial < 200; ++trial) {
+      const size_t i = EndgameTable::index(random_position(rng, tricks_left));
+      ASSERT_TRUE(i < EndgameTable::num_entries(tricks_left));
+      seen.insert(i);
+    }
+    ASSERT_TRUE(seen.size() > 10u);
+  }
+}
+
+TEST(test_endgame_table_matches_solver) {
+  ASSERT_TRUE(EndgameTable::write(TABLE_FILE, 2, generate_endgame_table(2, 2)));
+  EndgameTable table;
+  ASSERT_TRUE(table.open(TABLE_FILE));
+  ASSERT_EQUAL(table.get_tricks(), 2);
+
+  Rng rng(8);
+  DoubleDummySolver solver;
+  for (int trial = 0; trial < 500; ++trial) {
+    const Position pos = random_position(rng, 1 + trial % 2);
+    ASSERT_EQUAL(table.team0_tricks(pos), solver.team0_tricks(pos));
+  }
+
+  // Solving whole hands gives the same tricks with fewer positions searched
+  DoubleDummySolver plain;
+  DoubleDummySolver with_table(nullptr, &table);
+  for (int deal = 0; deal < 10; ++deal) {
+    const Position pos = random_position(rng, 5);
+    ASSERT_EQUAL(with_table.team0_tricks(pos), plain.team0_tricks(pos));
+    Position mid = pos;
+    mid.play(mid.legal().first());
+    ASSERT_EQUAL(with_table.team0_tricks(mid), plain.team0_tricks(mid));
+  }
+  ASSERT_TRUE(with_table.get_nodes() < plain.get_nodes());
+
+  ASSERT_TRUE(EndgameTable::shared(TABLE_FILE) != nullptr);
+  ASSERT_TRUE(EndgameTable::shared(TABLE_FILE)
+              == EndgameTable::shared(TABLE_FILE));
+  remove(TABLE_FILE);
+}
+
+TEST(test_endgame_table_rejects_other_files) {
+  EndgameTable table;
+  ASSERT_FALSE(table.open("no_such_endgame_table.bin"));
+  ASSERT_FALSE(table.open("pack.in"));
+  ASSERT_TRUE(EndgameTable::shared("no_such_endgame_table.bin") == nullptr);
+}
+
+TEST_MAIN()
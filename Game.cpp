@@ -0,0 +1,261 @@
+// Game.cpp
+#include "Game.hpp"
+#include "Profile.hpp"
+#include <cassert>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+
+Game::Game(Pack &pack_in, bool do_shuffle_in, int points_to_win_in,
+           const vector<Player*> &players_in)
+    : pack(pack_in),
+      do_shuffle(do_shuffle_in),
+      points_to_win(points_to_win_in),
+      players(players_in),
+      sink(&null_sink),
+      dealer(0),
+      hand_number(0) {
+  state.points = {{0, 0}};
+}
+
+void Game::set_sink(GameSink &sink_in) {
+  sink = &sink_in;
+}
+
+void Game::set_rng(Rng *rng_in) {
+  rng = rng_in;
+}
+
+void Game::set_deals(const vector<Pack::Permutation> *deals_in) {
+  deals = deals_in;
+}
+
+void Game::play() {
+  PROFILE_SCOPE(PHASE_GAME);
+  dealer = 0;
+  hand_number = 0;
+  // team 0 is players 0 & 2, team 1 is players 1 & 3
+  state.points = {{0, 0}};
+  const array<int, 2> &points = state.points;
+
+  while (points[0] < points_to_win && points[1] < points_to_win) {
+    play_one_hand();
+
+    // Next hand
+    dealer = (dealer + 1) % 4;
+    ++hand_number;
+  }
+
+  PROFILE_SCOPE(PHASE_OUTPUT);
+  sink->on_game_over({points[0] >= points_to_win ? 0 : 1, points});
+}
+
+void Game::play_one_hand() {
+  PROFILE_COUNT(COUNT_HANDS, 1);
+  // Reset/shuffle at the start of *each* hand per spec
+  shuffle_pack();
+  deal();
+
+  // Turn up the next card
+  const Card upcard = pack.deal_one();
+  {
+    PROFILE_SCOPE(PHASE_OUTPUT);
+    sink->on_deal({hand_number, dealer, upcard, state.hands});
+  }
+  {
+    PROFILE_SCOPE(PHASE_OBSERVE);
+    for (int seat = 0; seat < 4; ++seat) {
+      players[seat]->observe_deal(seat, dealer, upcard);
+    }
+  }
+
+  const TrumpEvent made = make_trump(upcard);
+  {
+    PROFILE_SCOPE(PHASE_OUTPUT);
+    sink->on_trump(made);
+  }
+  {
+    PROFILE_SCOPE(PHASE_OBSERVE);
+    for (Player *p : players) {
+      p->observe_trump(made);
+    }
+  }
+
+  // Play the 5 tricks
+  play_hand((dealer + 1) % 4, made.trump);
+  apply_scoring(made.maker);
+}
+
+void Game::shuffle_pack() {
+  PROFILE_SCOPE(PHASE_SHUFFLE);
+  if (deals) {
+    assert(hand_number < static_cast<int>(deals->size()));
+    pack = Pack();
+    pack.permute((*deals)[hand_number]);
+  } else if (do_shuffle && rng) {
+    pack.shuffle(*rng);
+  } else if (do_shuffle) {
+    pack.shuffle();
+  } else {
+    pack.reset();
+  }
+}
+
+void Game::deal() {
+  PROFILE_SCOPE(PHASE_DEAL);
+  state.hands.fill(Hand());
+
+  // Round 1 (left of dealer): 3-2-3-2
+  const int r1[4] = {3, 2, 3, 2};
+  // Round 2 (left of dealer): 2-3-2-3
+  const int r2[4] = {2, 3, 2, 3};
+
+  for (int i = 1; i <= 4; ++i) {
+    int p = (dealer + i) % 4;
+    for (int c = 0; c < r1[i - 1]; ++c) {
+      deal_to(p);
+    }
+  }
+  for (int i = 1; i <= 4; ++i) {
+    int p = (dealer + i) % 4;
+    for (int c = 0; c < r2[i - 1]; ++c) {
+      deal_to(p);
+    }
+  }
+}
+
+void Game::deal_to(int seat) {
+  const Card c = pack.deal_one();
+  state.hands[seat].add(c);
+  players[seat]->add_card(c);
+}
+
+// A play is legal if the seat holds the card and follows suit when able
+bool Game::is_legal_play(int seat, const Card &played, const Card &led,
+                         Suit trump) const {
+  const Hand hand = state.hands[seat];
+  return hand.contains(played)
+         && legal_moves(hand, led, trump).contains(played);
+}
+
+// Checked in every build: with only an assert, an NDEBUG build would play
+// on with a card nobody holds
+void Game::check_legal(bool legal, int seat, const char *action,
+                       const Card &card) const {
+  if (!legal) {
+    ostringstream message;
+    message << players[seat]->get_name() << ' ' << action << ' ' << card
+            << ", which is not legal";
+    throw logic_error(message.str());
+  }
+}
+
+// Handles both rounds of making trump and dealer add/discard if ordered up
+TrumpEvent Game::make_trump(const Card &upcard) {
+  PROFILE_SCOPE(PHASE_MAKE_TRUMP);
+  TrumpEvent made{-1, 0, upcard.get_suit()};
+  for (int round = 1; round <= 2; ++round) {
+    for (int i = 1; i <= 4; ++i) {
+      if (bid(upcard, round, (dealer + i) % 4, made)) {
+        return made;
+      }
+    }
+  }
+
+  // By project rules/tests this shouldn't happen (someone must choose),
+  // but guard anyway to avoid UB in scoring.
+  // Fallback: dealer becomes maker with the upcard suit.
+  made.maker = dealer;
+  return made;
+}
+
+// Asks one seat to bid, and records the maker in made if they order up
+bool Game::bid(const Card &upcard, int round, int seat, TrumpEvent &made) {
+  PROFILE_COUNT(COUNT_BIDS, 1);
+  Suit suit = upcard.get_suit();
+  const bool order_up = PROFILE_CALL(PHASE_BID, seat,
+      players[seat]->make_trump(upcard, seat == dealer, round, suit));
+  {
+    PROFILE_SCOPE(PHASE_OUTPUT);
+    sink->on_bid({seat, round, order_up, suit});
+  }
+  if (!order_up) {
+    return false;
+  }
+  made = {seat, round, suit};
+  if (round == 1) {
+    // Dealer must add and discard
+    const Card discard = PROFILE_CALL(PHASE_DISCARD, dealer,
+        players[dealer]->add_and_discard(upcard));
+    state.hands[dealer].add(upcard);
+    check_legal(state.hands[dealer].contains(discard), dealer, "discarded",
+                discard);
+    state.hands[dealer].remove(discard);
+  }
+  return true;
+}
+
+void Game::play_hand(int leader, Suit trump) {
+  PROFILE_SCOPE(PHASE_PLAY_HAND);
+  state.start_hand(trump, leader);
+  while (!state.hand_over()) {
+    play_trick(trump); // winner leads next trick
+  }
+}
+
+void Game::play_trick(Suit trump) {
+  const int trick = state.trick_number();
+  const int leader = state.leader();
+  PROFILE_COUNT(COUNT_TRICKS, 1);
+  const Card led = PROFILE_CALL(PHASE_LEAD, leader,
+                                players[leader]->lead_card(trump));
+  check_legal(state.hands[leader].contains(led), leader, "led", led);
+  state.make_move(led);
+  report_play({leader, led, true});
+
+  int winner = -1;
+  for (int i = 1; i <= 3; ++i) {
+    const int idx = (leader + i) % 4;
+    const Card played = PROFILE_CALL(PHASE_PLAY, idx,
+                                     players[idx]->play_card(led, trump));
+    check_legal(is_legal_play(idx, played, led, trump), idx, "played",
+                played);
+    winner = state.make_move(played);
+    report_play({idx, played, false});
+  }
+
+  PROFILE_SCOPE(PHASE_OUTPUT);
+  sink->on_trick({trick, winner});
+}
+
+void Game::report_play(const PlayEvent &e) {
+  PROFILE_COUNT(COUNT_CARDS, 1);
+  {
+    PROFILE_SCOPE(PHASE_OUTPUT);
+    sink->on_play(e);
+  }
+  PROFILE_SCOPE(PHASE_OBSERVE);
+  for (Player *p : players) {
+    p->observe_play(e);
+  }
+}
+
+// Makers score 1 for three or four tricks and 2 for a march; if they take
+// fewer than three they are euchred and the defenders score 2.
+void Game::apply_scoring(int maker) {
+  PROFILE_SCOPE(PHASE_SCORING);
+  const array<int, 2> tricks = {{state.tricks[0], state.tricks[1]}};
+  array<int, 2> &points = state.points;
+  const int makers = maker % 2;
+  const int defenders = 1 - makers;
+  const bool march = tricks[makers] == 5;
+  const bool euchred = tricks[makers] < 3;
+
+  if (euchred) {
+    points[defenders] += 2;
+  } else {
+    points[makers] += march ? 2 : 1;
+  }
+  sink->on_hand({maker, tricks, points, march, euchred});
+}
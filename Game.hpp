@@ -0,0 +1,81 @@
+#ifndef GAME_HPP
+#define GAME_HPP
+/* Game.hpp
+ *
+ * Plays games of euchre between four Players
+ */
+
+#include "Card.hpp"
+#include "GameSink.hpp"
+#include "GameState.hpp"
+#include "Hand.hpp"
+#include "Pack.hpp"
+#include "Player.hpp"
+#include "Random.hpp"
+#include <array>
+#include <vector>
+
+class Game {
+public:
+  // REQUIRES: players holds four Players, seated in order
+  // EFFECTS: Initializes a Game that deals from pack.  Events go to a null
+  //          sink until set_sink is called.  pack and the players must
+  //          outlive the Game.
+  Game(Pack &pack_in, bool do_shuffle_in, int points_to_win_in,
+       const std::vector<Player*> &players_in);
+
+  // EFFECTS: Sends events to sink_in from now on.  sink_in must outlive
+  //          the Game.
+  void set_sink(GameSink &sink_in);
+
+  // EFFECTS: Makes shuffled hands use a random shuffle drawn from rng
+  //          instead of the in-shuffle.  rng must outlive the Game.
+  void set_rng(Rng *rng_in);
+
+  // REQUIRES: deals_in holds a permutation for every hand that will be
+  //           played
+  // EFFECTS: Makes hand h deal the standard Pack reordered by
+  //          (*deals_in)[h] instead of shuffling, as when replaying a
+  //          recorded game.  deals_in must outlive the Game.
+  void set_deals(const std::vector<Pack::Permutation> *deals_in);
+
+  // EFFECTS: Plays one game to points_to_win, starting with player 0
+  //          dealing.  Throws std::logic_error, naming the player, if a
+  //          player discards or leads a card it does not hold, or plays
+  //          one it does not hold or that does not follow suit when it
+  //          can.
+  void play();
+
+private:
+  Pack &pack;
+  bool do_shuffle;
+  int points_to_win;
+  std::vector<Player*> players;
+  GameSink null_sink;
+  GameSink *sink;
+  Rng *rng = nullptr;
+  const std::vector<Pack::Permutation> *deals = nullptr;
+  int dealer;
+  int hand_number;
+
+  // Cards each seat still holds, the trick and the scores.  The hands are
+  // used to validate plays.
+  GameState state;
+
+  void play_one_hand();
+  void shuffle_pack();
+  void deal();
+  void deal_to(int seat);
+  bool is_legal_play(int seat, const Card &played, const Card &led,
+                     Suit trump) const;
+  void check_legal(bool legal, int seat, const char *action,
+                   const Card &card) const;
+  TrumpEvent make_trump(const Card &upcard);
+  bool bid(const Card &upcard, int round, int seat, TrumpEvent &made);
+  void play_hand(int leader, Suit trump);
+  void play_trick(Suit trump);
+  void report_play(const PlayEvent &e);
+  void apply_scoring(int maker);
+};
+
+#endif // GAME_HPP
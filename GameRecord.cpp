@@ -0,0 +1,483 @@
+// GameRecord.cpp
+#include "GameRecord.hpp"
+#include "Game.hpp"
+#include "Player.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+
+// BINOMIAL[n][k] is n choose k, for ranking the cards dealt to a seat
+static constexpr array<array<int, 6>, Hand::NUM_CARDS + 1> make_binomials() {
+  array<array<int, 6>, Hand::NUM_CARDS + 1> b = {};
+  for (int n = 0; n <= Hand::NUM_CARDS; ++n) {
+    b[n][0] = 1;
+    for (int k = 1; k < 6 && k <= n; ++k) {
+      b[n][k] = b[n - 1][k - 1] + (k < n ? b[n - 1][k] : 0);
+    }
+  }
+  return b;
+}
+
+static constexpr array<array<int, 6>, Hand::NUM_CARDS + 1> BINOMIAL =
+    make_binomials();
+
+static_assert(NUM_DEALS < (uint64_t(1) << 49),
+              "a deal index should fit in 49 bits");
+
+// Colex rank of subset among the (k choose size) subsets of among, with
+// the cards of among numbered in bit order
+static uint64_t subset_rank(Hand subset, Hand among) {
+  uint64_t rank = 0;
+  int k = 0;
+  int position = 0;
+  for (uint32_t rest = among.get_bits(); rest; rest &= rest - 1) {
+    if (subset.get_bits() & rest & -rest) {
+      rank += BINOMIAL[position][++k];
+    }
+    ++position;
+  }
+  return rank;
+}
+
+// Inverse of subset_rank for subsets of k cards
+static Hand subset_unrank(uint64_t rank, int k, Hand among) {
+  const int n = among.size();
+  Hand subset;
+  for (int i = k; i > 0; --i) {
+    int position = i - 1;
+    while (position + 1 < n && uint64_t(BINOMIAL[position + 1][i]) <= rank) {
+      ++position;
+    }
+    rank -= BINOMIAL[position][i];
+    uint32_t rest = among.get_bits();
+    for (int skip = 0; skip < position; ++skip) {
+      rest &= rest - 1;
+    }
+    subset = subset | Hand(rest & -rest);
+  }
+  return subset;
+}
+
+uint64_t deal_index(const array<Hand, 4> &dealt, const Card &upcard) {
+  Hand rest = Hand::full();
+  uint64_t index = 0;
+  for (const Hand &hand : dealt) {
+    assert(hand.size() == 5 && (hand & rest) == hand);
+    index = index * BINOMIAL[rest.size()][5] + subset_rank(hand, rest);
+    rest = rest.without(hand);
+  }
+  assert(rest.contains(upcard));
+  return index * rest.size() + subset_rank(Hand::of(upcard), rest);
+}
+
+void deal_from_index(uint64_t index, array<Hand, 4> &dealt, Card &upcard) {
+  assert(index < NUM_DEALS);
+  // Peel off the digits, last first, then deal them out in order
+  const uint64_t upcard_rank = index % 4;
+  index /= 4;
+  array<uint64_t, 4> ranks;
+  for (int seat = 3; seat >= 0; --seat) {
+    const int radix = BINOMIAL[Hand::NUM_CARDS - 5 * seat][5];
+    ranks[seat] = index % radix;
+    index /= radix;
+  }
+  Hand rest = Hand::full();
+  for (int seat = 0; seat < 4; ++seat) {
+    dealt[seat] = subset_unrank(ranks[seat], 5, rest);
+    rest = rest.without(dealt[seat]);
+  }
+  upcard = subset_unrank(upcard_rank, 1, rest).first();
+}
+
+// Where c sits in a Pack in standard order
+static unsigned char standard_position(const Card &c) {
+  return c.get_suit() * (ACE - NINE + 1) + c.get_rank() - NINE;
+}
+
+Pack::Permutation deal_order(const HandRecord &hand, int dealer) {
+  // Each seat's cards go out lowest first, following Game's 3-2-3-2 then
+  // 2-3-2-3 deal from the dealer's left
+  const int rounds[2][4] = {{3, 2, 3, 2}, {2, 3, 2, 3}};
+  array<Hand, 4> left = hand.dealt;
+  Pack::Permutation perm;
+  int next = 0;
+  for (const auto &counts : rounds) {
+    for (int i = 1; i <= 4; ++i) {
+      Hand &seat = left[(dealer + i) % 4];
+      for (int c = 0; c < counts[i - 1]; ++c) {
+        const Card card = seat.first();
+        seat.remove(card);
+        perm[next++] = standard_position(card);
+      }
+    }
+  }
+  perm[next++] = standard_position(hand.upcard);
+
+  // The cards nobody saw fill out the Pack
+  Hand kitty = Hand::full().without(Hand::of(hand.upcard));
+  for (const Hand &dealt : hand.dealt) {
+    kitty = kitty.without(dealt);
+  }
+  for (; !kitty.empty(); kitty.remove(kitty.first())) {
+    perm[next++] = standard_position(kitty.first());
+  }
+  assert(next == Pack::PACK_SIZE);
+  return perm;
+}
+
+/////////////// Writing and reading ///////////////
+
+// A card's position in a Hand mask, 0 to 23, which fits in 5 bits
+static int hand_position(const Card &c) {
+  return c.get_index() - Hand::FIRST_INDEX;
+}
+
+// Packs values into bytes, low bit first
+class BitWriter {
+public:
+  explicit BitWriter(string &out_in) : out(out_in) {}
+
+  void put(uint64_t value, int bits) {
+    while (bits > 0) {
+      const int take = min(bits, 8 - used);
+      current |= (value & ((1u << take) - 1)) << used;
+      used += take;
+      value >>= take;
+      bits -= take;
+      if (used == 8) {
+        flush();
+      }
+    }
+  }
+
+  // Pads the last byte with zero bits
+  void flush() {
+    if (used > 0) {
+      out.push_back(static_cast<char>(current));
+    }
+    current = 0;
+    used = 0;
+  }
+
+private:
+  string &out;
+  unsigned current = 0;
+  int used = 0;
+};
+
+// Unpacks values written by BitWriter
+class BitReader {
+public:
+  explicit BitReader(const char *in_in) : in(in_in) {}
+
+  uint64_t get(int bits) {
+    uint64_t value = 0;
+    int done = 0;
+    while (done < bits) {
+      const int take = min(bits - done, 8 - used);
+      const unsigned byte = static_cast<unsigned char>(in[next]);
+      value |= uint64_t((byte >> used) & ((1u << take) - 1)) << done;
+      used += take;
+      done += take;
+      if (used == 8) {
+        ++next;
+        used = 0;
+      }
+    }
+    return value;
+  }
+
+private:
+  const char *in;
+  size_t next = 0;
+  int used = 0;
+};
+
+static void put_hand(BitWriter &bits, const HandRecord &hand) {
+  bits.put(deal_index(hand.dealt, hand.upcard), 49);
+  bits.put(hand.passes, 4);
+  bits.put(hand.trump, 2);
+  for (const Card &c : hand.plays) {
+    bits.put(hand_position(c), 5);
+  }
+}
+
+void pack_hand(const HandRecord &hand, unsigned char *out) {
+  string packed;
+  BitWriter bits(packed);
+  put_hand(bits, hand);
+  bits.flush();
+  assert(packed.size() == HAND_RECORD_BYTES);
+  memcpy(out, packed.data(), HAND_RECORD_BYTES);
+}
+
+static void put_string(string &out, const string &s, int length_bytes) {
+  BitWriter(out).put(s.size(), 8 * length_bytes);
+  out += s;
+}
+
+void write_record_preamble(ostream &os, const string &preamble) {
+  assert(preamble.size() < (1u << 16));
+  string out;
+  put_string(out, preamble, 2);
+  os.write(out.data(), out.size());
+}
+
+void write_game_record(ostream &os, const GameRecord &record) {
+  assert(record.hands.size() < (1u << 16));
+  assert(0 < record.points_to_win && record.points_to_win < 256);
+  string out;
+  for (const string &name : record.names) {
+    assert(name.size() < 256);
+    put_string(out, name, 1);
+  }
+  BitWriter bits(out);
+  bits.put(record.points_to_win, 8);
+  bits.put(record.hands.size(), 16);
+  for (const HandRecord &hand : record.hands) {
+    put_hand(bits, hand);
+  }
+  bits.flush();
+  os.write(out.data(), out.size());
+}
+
+// Reads n bytes from is into out, returning false if there are not n
+static bool read_bytes(istream &is, string &out, size_t n) {
+  out.resize(n);
+  return n == 0 || is.read(&out[0], n);
+}
+
+// Reads a string preceded by its length in length_bytes bytes
+static bool read_string(istream &is, string &out, int length_bytes) {
+  string length;
+  return read_bytes(is, length, length_bytes)
+         && read_bytes(is, out,
+                       BitReader(length.data()).get(8 * length_bytes));
+}
+
+// Returns true if Game could have played hand's cards in order, with
+// dealer dealing: the trump agrees with the passes, and each card is held
+// by the seat whose turn it is and follows suit if that seat can
+static bool is_legal_hand(const HandRecord &hand, int dealer) {
+  // Everyone passing leaves the dealer making the upcard's suit
+  const bool round1 = hand.passes < 4 || hand.passes == 8;
+  if ((hand.trump == hand.upcard.get_suit()) != round1) {
+    return false;
+  }
+  GameState state;
+  state.hands = hand.dealt;
+  if (hand.passes < 4) {
+    // The dealer picked up the upcard and discarded the card they never
+    // play.  A card played by another seat is caught below.
+    Hand discard = hand.dealt[dealer] | Hand::of(hand.upcard);
+    for (const Card &c : hand.plays) {
+      discard = discard.without(Hand::of(c));
+    }
+    if (discard.size() != 1) {
+      return false;
+    }
+    state.hands[dealer] = (hand.dealt[dealer] | Hand::of(hand.upcard))
+                          .without(discard);
+  }
+  state.start_hand(hand.trump, (dealer + 1) % 4);
+  for (const Card &c : hand.plays) {
+    if (!state.legal().contains(c)) {
+      return false;
+    }
+    state.make_move(c);
+  }
+  return true;
+}
+
+// Reads hand's fields, returning false if any is out of range or the
+// plays are not legal with dealer dealing
+static bool read_hand(BitReader &bits, int dealer, HandRecord &hand) {
+  const uint64_t index = bits.get(49);
+  hand.passes = bits.get(4);
+  hand.trump = static_cast<Suit>(bits.get(2));
+  if (index >= NUM_DEALS || hand.passes > 8) {
+    return false;
+  }
+  for (Card &c : hand.plays) {
+    const int position = bits.get(5);
+    if (position >= Hand::NUM_CARDS) {
+      return false;
+    }
+    c = Card::from_index(Hand::FIRST_INDEX + position);
+  }
+  deal_from_index(index, hand.dealt, hand.upcard);
+  return is_legal_hand(hand, dealer);
+}
+
+bool unpack_hand(const unsigned char *in, int dealer, HandRecord &hand) {
+  BitReader bits(reinterpret_cast<const char *>(in));
+  return read_hand(bits, dealer, hand);
+}
+
+bool read_record_preamble(istream &is, string &preamble) {
+  return read_string(is, preamble, 2);
+}
+
+ReadResult read_game_record(istream &is, GameRecord &record) {
+  // A failed stream also peeks EOF, but it has not ended cleanly
+  if (is.peek() == istream::traits_type::eof()) {
+    return is.fail() ? READ_ERROR : READ_END;
+  }
+  for (string &name : record.names) {
+    if (!read_string(is, name, 1)) {
+      return READ_ERROR;
+    }
+  }
+  string header;
+  if (!read_bytes(is, header, 3)) {
+    return READ_ERROR;
+  }
+  BitReader header_bits(header.data());
+  record.points_to_win = header_bits.get(8);
+  record.hands.resize(header_bits.get(16));
+
+  string body;
+  const size_t bits = size_t(HAND_RECORD_BITS) * record.hands.size();
+  if (record.points_to_win == 0 || !read_bytes(is, body, (bits + 7) / 8)) {
+    return READ_ERROR;
+  }
+  BitReader body_bits(body.data());
+  for (size_t h = 0; h < record.hands.size(); ++h) {
+    if (!read_hand(body_bits, h % 4, record.hands[h])) {
+      return READ_ERROR;
+    }
+  }
+  return READ_OK;
+}
+
+/////////////// Replay ///////////////
+
+// Where a replay is up to, shared by its four players
+struct ReplayCursor {
+  const GameRecord &record;
+  int hand = -1;
+  int bids = 0;  // bids made so far this hand
+  int plays = 0; // cards played so far this hand
+
+  const HandRecord & current() const { return record.hands[hand]; }
+};
+
+// Makes the decisions recorded for its seat.  Game deals it cards, but it
+// never needs to look at them.
+class ReplayPlayer : public Player {
+public:
+  ReplayPlayer(const string &name_in, ReplayCursor &cursor_in)
+    : name(name_in), cursor(cursor_in) {}
+
+  const string & get_name() const override {
+    return name;
+  }
+
+  void add_card(const Card &) override {}
+
+  bool make_trump(const Card &, bool, int,
+                  Suit &order_up_suit) const override {
+    if (cursor.bids++ != cursor.current().passes) {
+      return false;
+    }
+    order_up_suit = cursor.current().trump;
+    return true;
+  }
+
+  // The dealer's discard is the one card they held that was never played
+  Card add_and_discard(const Card &upcard) override {
+    const HandRecord &hand = cursor.current();
+    Hand discard = hand.dealt[seat] | Hand::of(upcard);
+    for (const Card &c : hand.plays) {
+      discard = discard.without(Hand::of(c));
+    }
+    return discard.first();
+  }
+
+  Card lead_card(Suit) override {
+    return cursor.current().plays[cursor.plays++];
+  }
+
+  Card play_card(const Card &, Suit) override {
+    return cursor.current().plays[cursor.plays++];
+  }
+
+  void observe_deal(int seat_in, int, const Card &) override {
+    seat = seat_in;
+    if (seat == 0) {
+      ++cursor.hand;
+      cursor.bids = 0;
+      cursor.plays = 0;
+    }
+  }
+
+private:
+  string name;
+  ReplayCursor &cursor;
+  int seat = 0;
+};
+
+void replay_game(const GameRecord &record, ostream &os) {
+  TextSink transcript(
+      os, vector<string>(record.names.begin(), record.names.end()));
+  replay_game(record, transcript);
+}
+
+void replay_game(const GameRecord &record, GameSink &sink) {
+  vector<Pack::Permutation> deals;
+  for (size_t h = 0; h < record.hands.size(); ++h) {
+    deals.push_back(deal_order(record.hands[h], h % 4));
+  }
+  ReplayCursor cursor{record};
+  vector<ReplayPlayer> seats;
+  for (const string &name : record.names) {
+    seats.emplace_back(name, cursor);
+  }
+  vector<Player*> players;
+  for (ReplayPlayer &seat : seats) {
+    players.push_back(&seat);
+  }
+
+  Pack pack;
+  Game game(pack, false, record.points_to_win, players);
+  game.set_deals(&deals);
+  game.set_sink(sink);
+  game.play();
+  assert(cursor.hand + 1 == static_cast<int>(record.hands.size()));
+}
+
+/////////////// RecordSink ///////////////
+
+RecordSink::RecordSink(ostream &os_in, const vector<string> &names,
+                       int points_to_win)
+  : os(os_in) {
+  assert(names.size() == 4);
+  copy(names.begin(), names.end(), record.names.begin());
+  record.points_to_win = points_to_win;
+}
+
+void RecordSink::on_deal(const DealEvent &e) {
+  record.hands.emplace_back();
+  record.hands.back().dealt = e.hands;
+  record.hands.back().upcard = e.upcard;
+  played = 0;
+}
+
+void RecordSink::on_bid(const BidEvent &e) {
+  record.hands.back().passes += !e.order_up;
+}
+
+void RecordSink::on_trump(const TrumpEvent &e) {
+  record.hands.back().trump = e.trump;
+}
+
+void RecordSink::on_play(const PlayEvent &e) {
+  record.hands.back().plays[played++] = e.card;
+}
+
+void RecordSink::on_game_over(const GameOverEvent &) {
+  write_game_record(os, record);
+  record.hands.clear();
+}
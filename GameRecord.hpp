@@ -0,0 +1,138 @@
+#ifndef GAME_RECORD_HPP
+#define GAME_RECORD_HPP
+/* GameRecord.hpp
+ *
+ * A compact binary record of a game, holding just enough to play it again:
+ * each hand's deal, how the bidding went, and every card in the order it
+ * was played.  Replaying a record through Game regenerates its transcript.
+ * A file of records starts with a preamble, e.g. the command line that
+ * played them, and then holds one record per game.
+ */
+
+#include "Card.hpp"
+#include "GameSink.hpp"
+#include "GameState.hpp"
+#include "Hand.hpp"
+#include "Pack.hpp"
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// One hand of a game
+struct HandRecord {
+  std::array<Hand, 4> dealt; // the five cards dealt to each seat
+  Card upcard;
+  int passes = 0;            // passes before trump was made, 0 to 8.  8
+                             // means everyone passed and the dealer made
+                             // the upcard's suit.
+  Suit trump = SPADES;
+  std::array<Card, GameState::CARDS> plays; // in the order played
+};
+
+// One game, from the first deal to the last trick
+struct GameRecord {
+  std::array<std::string, 4> names;
+  int points_to_win = 0;
+  std::vector<HandRecord> hands;
+};
+
+// Number of ways to deal five cards to each seat and turn up an upcard
+const uint64_t NUM_DEALS = 42504ull * 11628 * 2002 * 126 * 4;
+
+// Bits each hand takes in a written record: the deal index, the passes,
+// the trump suit and a 5-bit Hand position for every card played
+const int HAND_RECORD_BITS = 49 + 4 + 2 + 5 * GameState::CARDS;
+const int HAND_RECORD_BYTES = (HAND_RECORD_BITS + 7) / 8;
+
+//REQUIRES dealt holds four disjoint five-card hands and upcard is in none
+//EFFECTS Returns a number below NUM_DEALS that only this deal maps to
+uint64_t deal_index(const std::array<Hand, 4> &dealt, const Card &upcard);
+
+//REQUIRES index < NUM_DEALS
+//MODIFIES dealt, upcard
+//EFFECTS Sets dealt and upcard to the deal with this deal_index
+void deal_from_index(uint64_t index, std::array<Hand, 4> &dealt,
+                     Card &upcard);
+
+//EFFECTS Returns the reordering of the standard Pack that deals hand's
+//  cards to each seat and then turns up hand's upcard when dealer deals
+Pack::Permutation deal_order(const HandRecord &hand, int dealer);
+
+//MODIFIES out
+//EFFECTS Writes hand's HAND_RECORD_BITS to out[0] through
+//  out[HAND_RECORD_BYTES - 1], packed as write_game_record packs them and
+//  padded with zero bits
+void pack_hand(const HandRecord &hand, unsigned char *out);
+
+//MODIFIES hand
+//EFFECTS Reads a hand packed by pack_hand from in, which dealer dealt.
+//  Returns false, leaving hand unspecified, if it is not well-formed: its
+//  trump must agree with its passes, and each card must be played by the
+//  seat whose turn it is, which holds it and follows suit if it can.
+bool unpack_hand(const unsigned char *in, int dealer, HandRecord &hand);
+
+//MODIFIES os
+//EFFECTS Writes the preamble that starts a file of records: its length
+//  in two little-endian bytes, then its text
+void write_record_preamble(std::ostream &os, const std::string &preamble);
+
+//MODIFIES is, preamble
+//EFFECTS Reads a preamble written by write_record_preamble into preamble.
+//  Returns false if is does not start with one.
+bool read_record_preamble(std::istream &is, std::string &preamble);
+
+//MODIFIES os
+//EFFECTS Writes record to os: the names and points_to_win, the number of
+//  hands, then HAND_RECORD_BITS for each hand, packed low bit first and
+//  padded to a whole byte.  Lengths and counts are little endian.
+void write_game_record(std::ostream &os, const GameRecord &record);
+
+// What read_game_record found
+enum ReadResult {
+  READ_OK,    // a record
+  READ_END,   // the end of the input, where a record would start
+  READ_ERROR  // a record cut short or not well-formed
+};
+
+//MODIFIES is, record
+//EFFECTS Reads the next record written by write_game_record into record.
+//  Returns READ_END if is ends before the record, and READ_ERROR, leaving
+//  record unspecified, if is holds a partial or ill-formed record.  Hand h
+//  of a game is dealt by seat h % 4, as Game deals them.
+ReadResult read_game_record(std::istream &is, GameRecord &record);
+
+//REQUIRES record was made from a game Game played, e.g. by RecordSink
+//MODIFIES os
+//EFFECTS Plays record through Game again, printing the transcript TextSink
+//  prints
+void replay_game(const GameRecord &record, std::ostream &os);
+
+//REQUIRES record is as for replay_game
+//MODIFIES sink
+//EFFECTS Plays record through Game again, sending its events to sink
+void replay_game(const GameRecord &record, GameSink &sink);
+
+// Records each game it sees, writing it with write_game_record when the
+// game is over
+class RecordSink : public GameSink {
+public:
+  //EFFECTS Initializes a sink that writes records of games between names
+  //  to points_to_win to os
+  RecordSink(std::ostream &os_in, const std::vector<std::string> &names,
+             int points_to_win);
+
+  void on_deal(const DealEvent &e) override;
+  void on_bid(const BidEvent &e) override;
+  void on_trump(const TrumpEvent &e) override;
+  void on_play(const PlayEvent &e) override;
+  void on_game_over(const GameOverEvent &e) override;
+
+private:
+  std::ostream &os;
+  GameRecord record;
+  int played = 0; // cards played so far this hand
+};
+
+#endif // GAME_RECORD_HPP
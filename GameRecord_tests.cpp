@@ -0,0 +1,241 @@
+#include "GameRecord.hpp"
+#include "Game.hpp"
+#include "unit_test_framework.hpp"
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+static const vector<string> NAMES = {"Edsger", "Fran", "Gabriel", "Herb"};
+
+static vector<Player*> simple_players() {
+  vector<Player*> players;
+  for (const string &name : NAMES) {
+    players.push_back(Player_factory(name, "Simple"));
+  }
+  return players;
+}
+
+// Plays one game, returning its transcript and writing its record to record
+static string play_and_record(Pack &pack, bool do_shuffle, int points,
+                              Rng *rng, ostream &record) {
+  vector<Player*> players = simple_players();
+  ostringstream oss;
+  TextSink transcript(oss, NAMES);
+  RecordSink recorder(record, NAMES, points);
+  TeeSink both(transcript, recorder);
+  Game game(pack, do_shuffle, points, players);
+  game.set_sink(both);
+  game.set_rng(rng);
+  game.play();
+  for (Player *p : players) delete p;
+  return oss.str();
+}
+
+// Returns true if record reads back after writing it
+static bool rewritten_reads(const GameRecord &record) {
+  ostringstream out;
+  write_game_record(out, record);
+  istringstream in(out.str());
+  GameRecord read;
+  return read_game_record(in, read) == READ_OK;
+}
+
+// Returns true if the same seat played cards i and j of hand, with dealer
+// dealing
+static bool same_seat(const HandRecord &hand, int dealer, int i, int j) {
+  GameState state;
+  state.hands.fill(Hand::full());
+  state.start_hand(hand.trump, (dealer + 1) % 4);
+  int seat_i = -1;
+  for (int k = 0; k < j; ++k) {
+    if (k == i) {
+      seat_i = state.to_play();
+    }
+    state.make_move(hand.plays[k]);
+  }
+  return seat_i == state.to_play();
+}
+
+TEST(test_deal_index_round_trip) {
+  Rng rng(11);
+  Pack pack;
+  for (int i = 0; i < 1000; ++i) {
+    pack.shuffle(rng);
+    array<Hand, 4> dealt;
+    for (Hand &hand : dealt) {
+      for (int c = 0; c < 5; ++c) hand.add(pack.deal_one());
+    }
+    const Card upcard = pack.deal_one();
+    const uint64_t index = deal_index(dealt, upcard);
+    ASSERT_TRUE(index < NUM_DEALS);
+
+    array<Hand, 4> decoded;
+    Card decoded_upcard;
+    deal_from_index(index, decoded, decoded_upcard);
+    ASSERT_TRUE(decoded == dealt);
+    ASSERT_EQUAL(decoded_upcard, upcard);
+  }
+
+  // The first and last deals sit at the ends of the range
+  array<Hand, 4> dealt;
+  Card upcard;
+  deal_from_index(0, dealt, upcard);
+  ASSERT_EQUAL(deal_index(dealt, upcard), 0u);
+  deal_from_index(NUM_DEALS - 1, dealt, upcard);
+  ASSERT_EQUAL(deal_index(dealt, upcard), NUM_DEALS - 1);
+}
+
+TEST(test_deal_order_deals_the_recorded_hands) {
+  HandRecord hand;
+  Card upcard;
+  deal_from_index(123456789, hand.dealt, upcard);
+  hand.upcard = upcard;
+  for (int dealer = 0; dealer < 4; ++dealer) {
+    Pack pack;
+    pack.permute(deal_order(hand, dealer));
+    // Seats receive 3-2-3-2 then 2-3-2-3 from the dealer's left
+    const int counts[8] = {3, 2, 3, 2, 2, 3, 2, 3};
+    array<Hand, 4> dealt;
+    for (int i = 0; i < 8; ++i) {
+      const int seat = (dealer + 1 + i) % 4;
+      for (int c = 0; c < counts[i]; ++c) dealt[seat].add(pack.deal_one());
+    }
+    ASSERT_TRUE(dealt == hand.dealt);
+    ASSERT_EQUAL(pack.deal_one(), upcard);
+  }
+}
+
+// The golden transcript for a 10 point game with shuffling replays byte
+// for byte from its record
+TEST(test_replay_matches_golden_transcript) {
+  ifstream golden_file("euchre_test01.out.correct");
+  string command_line;
+  getline(golden_file, command_line);
+  ostringstream golden;
+  golden << command_line << '\n' << golden_file.rdbuf();
+
+  ifstream pack_file("pack.in");
+  Pack pack(pack_file);
+  ostringstream record;
+  write_record_preamble(record, command_line + '\n');
+  const string played = play_and_record(pack, true, 10, nullptr, record);
+  ASSERT_EQUAL(command_line + '\n' + played, golden.str());
+
+  istringstream in(record.str());
+  string preamble;
+  ASSERT_TRUE(read_record_preamble(in, preamble));
+  GameRecord read;
+  ASSERT_EQUAL(read_game_record(in, read), READ_OK);
+  ASSERT_EQUAL(read.points_to_win, 10);
+  ASSERT_EQUAL(read.names[2], "Gabriel");
+  ostringstream replayed;
+  replayed << preamble;
+  replay_game(read, replayed);
+  ASSERT_EQUAL(replayed.str(), golden.str());
+
+  // Only one record, and it is about twenty bytes a hand
+  ASSERT_EQUAL(read_game_record(in, read), READ_END);
+  const size_t fixed = 2 + command_line.size() + 1 + 4 + 21 + 3;
+  ASSERT_EQUAL(record.str().size(),
+               fixed + (HAND_RECORD_BITS * read.hands.size() + 7) / 8);
+}
+
+TEST(test_replay_many_random_games) {
+  ostringstream records;
+  vector<string> transcripts;
+  for (int g = 0; g < 20; ++g) {
+    Rng rng(5, g);
+    Pack pack;
+    transcripts.push_back(play_and_record(pack, true, 11, &rng, records));
+  }
+
+  istringstream in(records.str());
+  GameRecord record;
+  for (const string &transcript : transcripts) {
+    ASSERT_EQUAL(read_game_record(in, record), READ_OK);
+    ostringstream replayed;
+    replay_game(record, replayed);
+    ASSERT_EQUAL(replayed.str(), transcript);
+  }
+  ASSERT_EQUAL(read_game_record(in, record), READ_END);
+}
+
+TEST(test_read_rejects_bad_records) {
+  ostringstream out;
+  Pack pack;
+  play_and_record(pack, false, 1, nullptr, out);
+  const string good = out.str();
+  GameRecord record;
+
+  // Cut short anywhere, even between fields, is not the end of the input
+  for (size_t size = 1; size < good.size(); ++size) {
+    istringstream truncated(good.substr(0, size));
+    ASSERT_EQUAL(read_game_record(truncated, record), READ_ERROR);
+  }
+  istringstream empty("");
+  ASSERT_EQUAL(read_game_record(empty, record), READ_END);
+
+  istringstream in(good);
+  ASSERT_EQUAL(read_game_record(in, record), READ_OK);
+  const GameRecord read = record;
+
+  // A card played twice
+  record.hands[0].plays[1] = record.hands[0].plays[0];
+  ASSERT_FALSE(rewritten_reads(record));
+
+  // The first two cards swapped, so the leader plays a card they never held
+  record = read;
+  swap(record.hands[0].plays[0], record.hands[0].plays[1]);
+  ASSERT_FALSE(rewritten_reads(record));
+
+  // Trump made in round 1 must be the upcard's suit
+  record = read;
+  record.hands[0].passes = 0;
+  record.hands[0].trump = Suit_next(record.hands[0].upcard.get_suit());
+  ASSERT_FALSE(rewritten_reads(record));
+}
+
+TEST(test_read_rejects_reneging) {
+  // In random games, find a seat that follows suit while holding a card it
+  // plays later in the hand, and have it play that card instead
+  int reneges = 0;
+  for (int g = 0; g < 20 && reneges < 10; ++g) {
+    ostringstream out;
+    Rng rng(6, g);
+    Pack pack;
+    play_and_record(pack, true, 5, &rng, out);
+    istringstream in(out.str());
+    GameRecord record;
+    ASSERT_EQUAL(read_game_record(in, record), READ_OK);
+    for (size_t h = 0; h < record.hands.size(); ++h) {
+      const HandRecord hand = record.hands[h];
+      for (int i = 0; i < GameState::CARDS; ++i) {
+        if (i % 4 == 0) {
+          continue;
+        }
+        const Card led = hand.plays[i - i % 4];
+        const Suit led_suit = led.get_suit(hand.trump);
+        if (hand.plays[i].get_suit(hand.trump) != led_suit) {
+          continue;
+        }
+        // A play of the next trick, if the same seat made it off that suit
+        const int j = i + 4;
+        if (j >= GameState::CARDS
+            || hand.plays[j].get_suit(hand.trump) == led_suit
+            || !same_seat(hand, h % 4, i, j)) {
+          continue;
+        }
+        GameRecord renege = record;
+        swap(renege.hands[h].plays[i], renege.hands[h].plays[j]);
+        ASSERT_FALSE(rewritten_reads(renege));
+        ++reneges;
+        break;
+      }
+    }
+  }
+  ASSERT_TRUE(reneges > 0);
+}
+
+TEST_MAIN()
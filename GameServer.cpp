@@ -0,0 +1,765 @@
+// GameServer.cpp
+#include "GameServer.hpp"
+#include "Game.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// A line longer than this is not the protocol, so its sender is dropped
+static const size_t MAX_LINE = 1024;
+
+// Events handled per epoll_wait
+static const int MAX_EVENTS = 64;
+
+struct GameServer::Connection {
+  int fd;
+  string in;              // read but not yet a whole line
+  string out;             // not yet written
+  bool polling_out = false; // the socket was full, so epoll waits for room
+  bool dirty = false;     // in dirty, to be written this turn
+  bool closing = false;
+
+  Table *table = nullptr;
+  int seat = -1;
+  AsyncSeat *asked = nullptr; // the seat waiting on this connection
+  DecisionRequest request;    // what it asked
+};
+
+struct GameServer::Table {
+  int id;
+  int players;                 // seats for connections, the first ones
+  array<Connection *, 4> seats = {}; // null once a connection leaves
+  vector<string> names;
+  ostringstream log;           // transcript not yet sent
+};
+
+// Returns true if address names a TCP port rather than a Unix socket
+static bool is_port(const string &address) {
+  return !address.empty()
+    && address.find_first_not_of("0123456789") == string::npos;
+}
+
+// Makes a socket for address, and fills in where it lives.  Returns -1 on
+// error.
+static int make_socket(const string &address, sockaddr_storage &where,
+                       socklen_t &where_size) {
+  memset(&where, 0, sizeof(where));
+  if (is_port(address)) {
+    const long port = strtol(address.c_str(), nullptr, 10);
+    if (port < 1 || port > 65535) {
+      return -1;
+    }
+    sockaddr_in &in = reinterpret_cast<sockaddr_in &>(where);
+    in.sin_family = AF_INET;
+    in.sin_port = htons(static_cast<uint16_t>(port));
+    in.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    where_size = sizeof(in);
+    return socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  }
+  sockaddr_un &un = reinterpret_cast<sockaddr_un &>(where);
+  if (address.size() >= sizeof(un.sun_path)) {
+    return -1;
+  }
+  un.sun_family = AF_UNIX;
+  memcpy(un.sun_path, address.c_str(), address.size() + 1);
+  where_size = sizeof(un);
+  return socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+}
+
+// Sends small messages at once instead of waiting to fill a packet
+static void set_no_delay(int fd, const string &address) {
+  if (is_port(address)) {
+    const int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  }
+}
+
+// Reads a card as transcripts write it.  Returns false if text is not one.
+static bool parse_card(const string &text, Card &card) {
+  for (int i = Hand::FIRST_INDEX; i < Card::NUM_INDICES; ++i) {
+    if (text == Card_name(Card::from_index(i))) {
+      card = Card::from_index(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool parse_suit(const string &text, Suit &suit) {
+  for (int s = SPADES; s <= DIAMONDS; ++s) {
+    if (text == Suit_name(static_cast<Suit>(s))) {
+      suit = static_cast<Suit>(s);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Reads a whole line as a number.  Returns false if it is not one.
+static bool parse_number(const string &text, long &n) {
+  if (text.empty()) {
+    return false;
+  }
+  char *end;
+  errno = 0;
+  n = strtol(text.c_str(), &end, 10);
+  return errno == 0 && *end == '\0';
+}
+
+//EFFECTS Returns the cards of hand, in order
+static vector<Card> cards_of(Hand hand) {
+  vector<Card> cards;
+  for (; !hand.empty(); hand = hand.without(Hand::of(hand.first()))) {
+    cards.push_back(hand.first());
+  }
+  return cards;
+}
+
+static string hand_line(Hand hand) {
+  string line = "HAND";
+  const char *separator = " ";
+  for (const Card &card : cards_of(hand)) {
+    line += separator;
+    line += Card_name(card);
+    separator = ", ";
+  }
+  return line;
+}
+
+static string ask_line(const DecisionRequest &request) {
+  switch (request.decision) {
+  case DECISION_MAKE_TRUMP:
+    return "ASK BID " + to_string(request.round)
+      + (request.is_dealer ? " dealer " : " player ")
+      + Card_name(request.upcard);
+  case DECISION_ADD_AND_DISCARD:
+    return "ASK DISCARD " + Card_name(request.upcard);
+  case DECISION_LEAD_CARD:
+    return string("ASK LEAD ") + Suit_name(request.trump);
+  default:
+    return string("ASK PLAY ") + Suit_name(request.trump) + " "
+      + Card_name(request.led);
+  }
+}
+
+/////////////// GameServer ///////////////
+
+GameServer::GameServer(int points_to_win_in, uint64_t seed_in)
+  : points_to_win(points_to_win_in), seed(seed_in), open_tables(4) {}
+
+GameServer::~GameServer() {
+  for (auto &entry : connections) {
+    close(entry.first);
+  }
+  if (listen_fd >= 0) close(listen_fd);
+  if (epoll_fd >= 0) close(epoll_fd);
+  if (stop_fd >= 0) close(stop_fd);
+  if (!unix_path.empty()) {
+    unlink(unix_path.c_str());
+  }
+}
+
+bool GameServer::listen(const string &address) {
+  sockaddr_storage where;
+  socklen_t where_size;
+  listen_fd = make_socket(address, where, where_size);
+  if (listen_fd < 0) {
+    return false;
+  }
+  if (is_port(address)) {
+    const int on = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  } else {
+    unlink(address.c_str());
+  }
+  if (::bind(listen_fd, reinterpret_cast<sockaddr *>(&where), where_size) < 0
+      || ::listen(listen_fd, SOMAXCONN) < 0) {
+    return false;
+  }
+  if (!is_port(address)) {
+    unix_path = address;
+  }
+  fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL) | O_NONBLOCK);
+  listen_address = address;
+
+  epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epoll_fd < 0 || stop_fd < 0) {
+    return false;
+  }
+  epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = listen_fd;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event);
+  event.data.fd = stop_fd;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &event);
+  return true;
+}
+
+void GameServer::stop() {
+  const uint64_t one = 1;
+  // Only fails if the count would overflow, so run() is already woken
+  if (write(stop_fd, &one, sizeof(one)) < 0) {
+    return;
+  }
+}
+
+void GameServer::run() {
+  epoll_event events[MAX_EVENTS];
+  bool stopping = false;
+  while (!stopping) {
+    const int ready = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+    if (ready < 0 && errno != EINTR) {
+      break;
+    }
+    for (int i = 0; i < ready; ++i) {
+      const int fd = events[i].data.fd;
+      if (fd == listen_fd) {
+        accept_connections();
+        continue;
+      }
+      if (fd == stop_fd) {
+        stopping = true;
+        continue;
+      }
+      auto found = connections.find(fd);
+      if (found == connections.end() || found->second->closing) {
+        continue;
+      }
+      Connection &connection = *found->second;
+      if (events[i].events & EPOLLOUT) {
+        write_to(connection);
+      }
+      if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+        read_from(connection);
+      }
+    }
+
+    // Every table answered above plays on to its next question
+    scheduler.run_ready();
+    end_turn();
+  }
+  finish_tables();
+}
+
+// Writes what the turn sent and frees what it closed or finished
+void GameServer::end_turn() {
+  for (int fd : dirty) {
+    auto found = connections.find(fd);
+    if (found != connections.end()) {
+      found->second->dirty = false;
+      if (!found->second->closing) {
+        write_to(*found->second);
+      }
+    }
+  }
+  dirty.clear();
+  for (int fd : closed) {
+    close(fd);
+    connections.erase(fd);
+  }
+  closed.clear();
+  for (int id : finished) {
+    tables.erase(id);
+  }
+  finished.clear();
+}
+
+// Plays out every game in progress with Simple players, so each client
+// gets DONE, and tells clients whose tables never filled that they will
+// not start
+void GameServer::finish_tables() {
+  finishing = true;
+  for (Table *&table : open_tables) {
+    if (!table) {
+      continue;
+    }
+    for (Connection *connection : table->seats) {
+      if (connection) {
+        send(*connection, "ERROR the server is stopping");
+        connection->table = nullptr;
+        connection->seat = -1;
+      }
+    }
+    finished.push_back(table->id);
+    table = nullptr;
+  }
+  for (auto &entry : connections) {
+    Connection &connection = *entry.second;
+    if (connection.asked) {
+      AsyncSeat *asked = connection.asked;
+      connection.asked = nullptr;
+      asked->answer(simple_answer(connection.request));
+    }
+  }
+  // No seat waits any more, so every table runs to the end
+  const size_t unfinished = scheduler.run_ready();
+  assert(unfinished == 0);
+  (void)unfinished;
+
+  // Give each client a moment to take the rest of its game
+  const timeval patience = {1, 0};
+  for (auto &entry : connections) {
+    Connection &connection = *entry.second;
+    if (!connection.closing && !connection.out.empty()) {
+      fcntl(connection.fd, F_SETFL,
+            fcntl(connection.fd, F_GETFL) & ~O_NONBLOCK);
+      setsockopt(connection.fd, SOL_SOCKET, SO_SNDTIMEO, &patience,
+                 sizeof(patience));
+      write_to(connection);
+    }
+    connection.dirty = false;
+  }
+  dirty.clear();
+  end_turn();
+}
+
+void GameServer::accept_connections() {
+  while (true) {
+    const int fd = accept4(listen_fd, nullptr, nullptr,
+                           SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      return;
+    }
+    set_no_delay(fd, listen_address);
+    unique_ptr<Connection> connection(new Connection);
+    connection->fd = fd;
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    connections[fd] = move(connection);
+  }
+}
+
+void GameServer::read_from(Connection &connection) {
+  char chunk[4096];
+  while (true) {
+    const ssize_t got = read(connection.fd, chunk, sizeof(chunk));
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+    if (got <= 0) {
+      close_connection(connection);
+      return;
+    }
+    connection.in.append(chunk, static_cast<size_t>(got));
+  }
+
+  size_t begin = 0;
+  size_t end;
+  while ((end = connection.in.find('\n', begin)) != string::npos) {
+    string line = connection.in.substr(begin, end - begin);
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    begin = end + 1;
+    handle_line(connection, line);
+    if (connection.closing) {
+      return;
+    }
+  }
+  connection.in.erase(0, begin);
+  if (connection.in.size() > MAX_LINE) {
+    close_connection(connection);
+  }
+}
+
+void GameServer::handle_line(Connection &connection, const string &line) {
+  istringstream words(line);
+  vector<string> tokens;
+  for (string word; words >> word;) {
+    tokens.push_back(word);
+  }
+  if (tokens.empty() || tokens[0] != "PLAY") {
+    answer(connection, line);
+    return;
+  }
+  long players = 1;
+  if (tokens.size() < 2 || tokens.size() > 3
+      || (tokens.size() == 3 && !parse_number(tokens[2], players))
+      || players < 1 || players > 4) {
+    send(connection, "ERROR expected PLAY NAME [PLAYERS], PLAYERS 1 to 4");
+    return;
+  }
+  if (connection.table) {
+    send(connection, "ERROR already seated");
+    return;
+  }
+  seat(connection, tokens[1], static_cast<int>(players));
+}
+
+void GameServer::seat(Connection &connection, const string &name,
+                      int players) {
+  Table *table = open_tables[players - 1];
+  if (!table) {
+    const int id = next_table++;
+    table = new Table;
+    tables[id].reset(table);
+    table->id = id;
+    table->players = players;
+    table->names = {"Bot0", "Bot1", "Bot2", "Bot3"};
+    open_tables[players - 1] = table;
+  }
+  int seat = 0;
+  while (table->seats[seat]) {
+    ++seat;
+  }
+  table->seats[seat] = &connection;
+  table->names[seat] = name;
+  connection.table = table;
+  connection.seat = seat;
+  send(connection, "SEATED " + to_string(table->id) + " " + to_string(seat));
+
+  for (seat = 0; seat < players; ++seat) {
+    if (!table->seats[seat]) {
+      return;
+    }
+  }
+  open_tables[players - 1] = nullptr;
+  start(*table);
+}
+
+void GameServer::start(Table &table) {
+  scheduler.add_table([this, &table] {
+    vector<unique_ptr<Player>> owned;
+    vector<Player *> players;
+    for (int seat = 0; seat < 4; ++seat) {
+      if (seat < table.players) {
+        owned.emplace_back(new AsyncSeat(table.names[seat], scheduler,
+            [this, &table, seat](AsyncSeat &player,
+                                 const DecisionRequest &request) {
+              ask(table, seat, player, request);
+            }));
+      } else {
+        owned.emplace_back(Player_factory(table.names[seat], "Simple"));
+      }
+      players.push_back(owned.back().get());
+    }
+    TextSink transcript(table.log, table.names);
+    Rng rng(seed, static_cast<uint64_t>(table.id));
+    Pack pack;
+    Game game(pack, true, points_to_win, players);
+    game.set_sink(transcript);
+    game.set_rng(&rng);
+    game.play();
+
+    send_log(table);
+    for (Connection *connection : table.seats) {
+      if (connection) {
+        send(*connection, "DONE");
+        connection->table = nullptr;
+        connection->seat = -1;
+      }
+    }
+    finished.push_back(table.id);
+  });
+}
+
+void GameServer::ask(Table &table, int seat, AsyncSeat &player,
+                     const DecisionRequest &request) {
+  Connection *connection = table.seats[seat];
+  if (!connection || finishing) {
+    player.answer(simple_answer(request));
+    return;
+  }
+  send_log(table);
+  connection->asked = &player;
+  connection->request = request;
+  send(*connection, hand_line(request.hand));
+  send(*connection, ask_line(request));
+}
+
+void GameServer::answer(Connection &connection, const string &line) {
+  if (!connection.asked) {
+    send(connection, "ERROR nothing was asked");
+    return;
+  }
+  const DecisionRequest &request = connection.request;
+  DecisionAnswer reply;
+  if (request.decision == DECISION_MAKE_TRUMP) {
+    reply.order_up = line != "pass";
+    if (reply.order_up && !parse_suit(line, reply.suit)) {
+      send(connection, "ERROR expected pass or a suit");
+      return;
+    }
+  } else {
+    const vector<Card> cards = cards_of(request.hand);
+    long position;
+    const bool may_discard_upcard =
+        request.decision == DECISION_ADD_AND_DISCARD;
+    if (!parse_number(line, position)
+        || position < (may_discard_upcard ? -1 : 0)
+        || position >= static_cast<long>(cards.size())) {
+      send(connection, "ERROR expected the position of a card");
+      return;
+    }
+    reply.card = position < 0 ? request.upcard : cards[position];
+  }
+  if (!connection.asked->answer(reply)) {
+    send(connection, "ERROR not legal");
+    return;
+  }
+  connection.asked = nullptr;
+}
+
+void GameServer::send_log(Table &table) {
+  const string text = table.log.str();
+  if (text.empty()) {
+    return;
+  }
+  table.log.str("");
+  size_t begin = 0;
+  size_t end;
+  while ((end = text.find('\n', begin)) != string::npos) {
+    const string line = "LOG " + text.substr(begin, end - begin);
+    for (Connection *connection : table.seats) {
+      if (connection) {
+        send(*connection, line);
+      }
+    }
+    begin = end + 1;
+  }
+}
+
+void GameServer::send(Connection &connection, const string &line) {
+  connection.out += line;
+  connection.out += '\n';
+  if (!connection.dirty && !connection.polling_out) {
+    connection.dirty = true;
+    dirty.push_back(connection.fd);
+  }
+}
+
+void GameServer::write_to(Connection &connection) {
+  size_t written = 0;
+  while (written < connection.out.size()) {
+    const ssize_t wrote = ::send(connection.fd, connection.out.data() + written,
+                                 connection.out.size() - written,
+                                 MSG_NOSIGNAL);
+    if (wrote < 0 && errno == EINTR) {
+      continue;
+    }
+    if (wrote < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    }
+    if (wrote < 0) {
+      close_connection(connection);
+      return;
+    }
+    written += static_cast<size_t>(wrote);
+  }
+  connection.out.erase(0, written);
+
+  // Wait for room only while there is something left to write
+  const bool want_out = !connection.out.empty();
+  if (want_out != connection.polling_out) {
+    epoll_event event = {};
+    event.events = want_out ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    event.data.fd = connection.fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.polling_out = want_out;
+  }
+}
+
+void GameServer::close_connection(Connection &connection) {
+  if (connection.closing) {
+    return;
+  }
+  connection.closing = true;
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection.fd, nullptr);
+  closed.push_back(connection.fd);
+
+  Table *table = connection.table;
+  if (!table) {
+    return;
+  }
+  // A Simple player takes over the seat, or frees it if the game has not
+  // started
+  table->seats[connection.seat] = nullptr;
+  table->names[connection.seat] = "Bot" + to_string(connection.seat);
+  if (connection.asked) {
+    connection.asked->answer(simple_answer(connection.request));
+  }
+}
+
+/////////////// SimpleClient ///////////////
+
+SimpleClient::~SimpleClient() {
+  if (fd >= 0) close(fd);
+}
+
+bool SimpleClient::connect(const string &address) {
+  sockaddr_storage where;
+  socklen_t where_size;
+  fd = make_socket(address, where, where_size);
+  if (fd < 0
+      || ::connect(fd, reinterpret_cast<sockaddr *>(&where), where_size) < 0) {
+    return false;
+  }
+  set_no_delay(fd, address);
+  return true;
+}
+
+bool SimpleClient::send_line(const string &line) {
+  const string text = line + "\n";
+  size_t written = 0;
+  while (written < text.size()) {
+    const ssize_t wrote = ::send(fd, text.data() + written,
+                                 text.size() - written, MSG_NOSIGNAL);
+    if (wrote < 0 && errno == EINTR) {
+      continue;
+    }
+    if (wrote < 0) {
+      return false;
+    }
+    written += static_cast<size_t>(wrote);
+  }
+  return true;
+}
+
+bool SimpleClient::read_line(string &line) {
+  size_t end;
+  while ((end = buffer.find('\n')) == string::npos) {
+    char chunk[4096];
+    const ssize_t got = read(fd, chunk, sizeof(chunk));
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      return false;
+    }
+    buffer.append(chunk, static_cast<size_t>(got));
+  }
+  line = buffer.substr(0, end);
+  buffer.erase(0, end + 1);
+  return true;
+}
+
+// Reads the rest of an ASK line into request.  Returns false if it is not
+// well-formed.
+static bool parse_ask(istringstream &words, DecisionRequest &request) {
+  string kind;
+  words >> kind;
+  string word;
+  string rest;
+  if (kind == "BID") {
+    request.decision = DECISION_MAKE_TRUMP;
+    words >> request.round >> word >> ws;
+    request.is_dealer = word == "dealer";
+    getline(words, rest);
+    return parse_card(rest, request.upcard);
+  }
+  if (kind == "DISCARD") {
+    request.decision = DECISION_ADD_AND_DISCARD;
+    getline(words >> ws, rest);
+    return parse_card(rest, request.upcard);
+  }
+  if (kind == "LEAD") {
+    request.decision = DECISION_LEAD_CARD;
+    return (words >> word) && parse_suit(word, request.trump);
+  }
+  request.decision = DECISION_PLAY_CARD;
+  if (kind != "PLAY" || !(words >> word) || !parse_suit(word, request.trump)) {
+    return false;
+  }
+  getline(words >> ws, rest);
+  return parse_card(rest, request.led);
+}
+
+// Reads the rest of a HAND line.  Returns false if it is not well-formed.
+static bool parse_hand(const string &text, Hand &hand) {
+  hand = Hand();
+  size_t begin = 0;
+  while (begin < text.size()) {
+    size_t end = text.find(", ", begin);
+    if (end == string::npos) {
+      end = text.size();
+    }
+    Card card;
+    if (!parse_card(text.substr(begin, end - begin), card)) {
+      return false;
+    }
+    hand = hand | Hand::of(card);
+    begin = end + 2;
+  }
+  return true;
+}
+
+// Writes reply as the protocol line answering request
+static string answer_line(const DecisionRequest &request,
+                          const DecisionAnswer &reply) {
+  if (request.decision == DECISION_MAKE_TRUMP) {
+    return reply.order_up ? Suit_name(reply.suit) : "pass";
+  }
+  if (request.decision == DECISION_ADD_AND_DISCARD
+      && reply.card == request.upcard) {
+    return "-1";
+  }
+  const vector<Card> cards = cards_of(request.hand);
+  return to_string(find(cards.begin(), cards.end(), reply.card)
+                   - cards.begin());
+}
+
+bool SimpleClient::play(const string &name, int players, string &transcript,
+                        LatencyHistogram *latencies) {
+  transcript.clear();
+  if (!send_line("PLAY " + name + " " + to_string(players))) {
+    return false;
+  }
+  DecisionRequest request;
+  bool answered = false;
+  chrono::steady_clock::time_point answered_at;
+  string line;
+  while (read_line(line)) {
+    istringstream words(line);
+    string keyword;
+    words >> keyword;
+    if (keyword == "LOG") {
+      transcript += line.size() > 4 ? line.substr(4) : "";
+      transcript += '\n';
+    } else if (keyword == "HAND") {
+      if (!parse_hand(line.size() > 5 ? line.substr(5) : "", request.hand)) {
+        return false;
+      }
+    } else if (keyword == "ASK") {
+      if (latencies && answered) {
+        latencies->record(static_cast<uint64_t>(
+            chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now() - answered_at).count()));
+      }
+      if (!parse_ask(words, request)) {
+        return false;
+      }
+      answered_at = chrono::steady_clock::now();
+      answered = true;
+      if (!send_line(answer_line(request, simple_answer(request)))) {
+        return false;
+      }
+    } else if (keyword == "DONE") {
+      return true;
+    } else if (keyword != "SEATED") {
+      return false;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,141 @@
+#ifndef GAME_SERVER_HPP
+#define GAME_SERVER_HPP
+/* GameServer.hpp
+ *
+ * Hosts many tables at once for players connecting over a local socket,
+ * all on one thread, and a client that plays at them as a Simple player
+ */
+
+#include "Latency.hpp"
+#include "TableScheduler.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// The protocol is one line per message, each starting with a keyword.
+//
+// From the client:
+//   PLAY NAME [PLAYERS]   Sit at the next table for PLAYERS (1 to 4,
+//                         default 1) connected players.  The other seats
+//                         get Simple players, and the game starts once the
+//                         table is full.
+//   pass | SUIT           Answers ASK BID
+//   POSITION              Answers ASK DISCARD, LEAD or PLAY with the
+//                         position of a card in the last HAND, or -1 to
+//                         discard the upcard
+//
+// From the server:
+//   SEATED TABLE SEAT
+//   LOG TEXT              A line of the table's transcript
+//   HAND CARD, CARD, ...  The client's cards, in order
+//   ASK BID ROUND dealer|player UPCARD
+//   ASK DISCARD UPCARD
+//   ASK LEAD TRUMP
+//   ASK PLAY TRUMP LED_CARD
+//   ERROR TEXT            The last line was not understood or not legal;
+//                         any question asked is still open
+//   DONE                  The game is over, and the client may PLAY again
+//
+// Cards are written as in transcripts, e.g. "Jack of Hearts".  A client
+// that disconnects mid-game is replaced by a Simple player.  When the
+// server stops, Simple players finish every game in progress, which ends
+// with DONE as usual, and a client waiting for its table to fill gets
+// ERROR.
+class GameServer {
+public:
+  //EFFECTS Initializes a server whose games are to points_to_win, the
+  //  games at table t shuffling from stream t of seed
+  GameServer(int points_to_win_in, uint64_t seed_in);
+
+  GameServer(const GameServer &) = delete;
+  GameServer & operator=(const GameServer &) = delete;
+  ~GameServer();
+
+  //MODIFIES this GameServer
+  //EFFECTS Listens on address: a port number for TCP on 127.0.0.1, or
+  //  else the path of a Unix-domain socket, which is replaced if it exists.
+  //  Returns false on error.
+  bool listen(const std::string &address);
+
+  //REQUIRES listen succeeded
+  //EFFECTS Serves until stop() is called, then finishes every game in
+  //  progress with Simple players and sends what is left to send
+  void run();
+
+  //EFFECTS Makes run() return soon.  Safe to call from any thread.
+  void stop();
+
+private:
+  struct Connection;
+  struct Table;
+
+  int points_to_win;
+  uint64_t seed;
+  int listen_fd = -1;
+  int epoll_fd = -1;
+  int stop_fd = -1;
+  std::string listen_address;
+  std::string unix_path;  // removed when the server is destroyed
+
+  TableScheduler scheduler;
+  std::unordered_map<int, std::unique_ptr<Connection>> connections; // by fd
+  std::unordered_map<int, std::unique_ptr<Table>> tables; // by table id
+  int next_table = 0;
+  std::vector<Table *> open_tables; // waiting for players, by size - 1
+  bool finishing = false;  // stopped, so every seat plays as Simple
+
+  // Left for the end of each turn of the event loop, by descriptor or id
+  std::vector<int> dirty;    // connections with lines to write
+  std::vector<int> closed;   // connections to free
+  std::vector<int> finished; // tables to free
+
+  void end_turn();
+  void finish_tables();
+  void accept_connections();
+  void read_from(Connection &connection);
+  void handle_line(Connection &connection, const std::string &line);
+  void seat(Connection &connection, const std::string &name, int players);
+  void answer(Connection &connection, const std::string &line);
+  void start(Table &table);
+  void ask(Table &table, int seat, AsyncSeat &player,
+           const DecisionRequest &request);
+  void send_log(Table &table);
+  void send(Connection &connection, const std::string &line);
+  void write_to(Connection &connection);
+  void close_connection(Connection &connection);
+};
+
+// Plays over one connection to a GameServer as a Simple player would,
+// blocking, for load tests and for standing in for people
+class SimpleClient {
+public:
+  SimpleClient() = default;
+  SimpleClient(const SimpleClient &) = delete;
+  SimpleClient & operator=(const SimpleClient &) = delete;
+  ~SimpleClient();
+
+  //MODIFIES this SimpleClient
+  //EFFECTS Connects to a GameServer listening on address, as for
+  //  GameServer::listen.  Returns false on error.
+  bool connect(const std::string &address);
+
+  //REQUIRES connect succeeded
+  //MODIFIES transcript, latencies
+  //EFFECTS Plays one game as name at a table for players connected
+  //  players.  Puts the table's transcript in transcript, and records in
+  //  latencies, if given, the time from each answer to the next question.
+  //  Returns false on error.
+  bool play(const std::string &name, int players, std::string &transcript,
+            LatencyHistogram *latencies = nullptr);
+
+private:
+  int fd = -1;
+  std::string buffer;  // read but not yet returned by read_line
+
+  bool send_line(const std::string &line);
+  bool read_line(std::string &line);
+};
+
+#endif // GAME_SERVER_HPP
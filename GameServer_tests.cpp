@@ -0,0 +1,225 @@
+#include "GameServer.hpp"
+#include "Game.hpp"
+#include "unit_test_framework.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char *const SOCKET_PATH = "GameServer_tests.sock";
+static const int POINTS = 10;
+static const uint64_t SEED = 7;
+
+// A server answering on SOCKET_PATH for as long as it is in scope
+class RunningServer {
+public:
+  RunningServer() : server(POINTS, SEED) {
+    ASSERT_TRUE(server.listen(SOCKET_PATH));
+    runner = thread([this] { server.run(); });
+  }
+
+  ~RunningServer() { stop(); }
+
+  // Stops the server and waits for run() to return
+  void stop() {
+    if (runner.joinable()) {
+      server.stop();
+      runner.join();
+    }
+  }
+
+private:
+  GameServer server;
+  thread runner;
+};
+
+// The transcript of the game at table, were its seats all Simple players
+static string expected_transcript(const vector<string> &names, int table) {
+  vector<Player*> players;
+  for (const string &name : names) {
+    players.push_back(Player_factory(name, "Simple"));
+  }
+  ostringstream out;
+  TextSink transcript(out, names);
+  Rng rng(SEED, table);
+  Pack pack;
+  Game game(pack, true, POINTS, players);
+  game.set_sink(transcript);
+  game.set_rng(&rng);
+  game.play();
+  for (Player *p : players) delete p;
+  return out.str();
+}
+
+// Speaks the protocol a line at a time, for checking what the server says
+class LineClient {
+public:
+  LineClient() {
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un where = {};
+    where.sun_family = AF_UNIX;
+    strcpy(where.sun_path, SOCKET_PATH);
+    ASSERT_EQUAL(connect(fd, reinterpret_cast<sockaddr *>(&where),
+                         sizeof(where)), 0);
+  }
+
+  ~LineClient() { close(fd); }
+
+  void send(const string &line) {
+    const string text = line + "\n";
+    ASSERT_EQUAL(write(fd, text.data(), text.size()),
+                 static_cast<ssize_t>(text.size()));
+  }
+
+  string read_line() {
+    size_t end;
+    while ((end = buffer.find('\n')) == string::npos) {
+      char chunk[4096];
+      const ssize_t got = read(fd, chunk, sizeof(chunk));
+      ASSERT_TRUE(got > 0);
+      buffer.append(chunk, got);
+    }
+    const string line = buffer.substr(0, end);
+    buffer.erase(0, end + 1);
+    return line;
+  }
+
+  // Reads lines until one starts with prefix, and returns it
+  string read_until(const string &prefix) {
+    string line;
+    do {
+      line = read_line();
+    } while (line.compare(0, prefix.size(), prefix) != 0);
+    return line;
+  }
+
+private:
+  int fd;
+  string buffer;
+};
+
+TEST(test_server_plays_with_simple_bots) {
+  RunningServer server;
+  SimpleClient client;
+  ASSERT_TRUE(client.connect(SOCKET_PATH));
+  // One client seats itself at a new table for every game
+  for (int table = 0; table < 3; ++table) {
+    string transcript;
+    ASSERT_TRUE(client.play("Ann", 1, transcript));
+    ASSERT_EQUAL(transcript,
+                 expected_transcript({"Ann", "Bot1", "Bot2", "Bot3"}, table));
+  }
+}
+
+TEST(test_server_seats_clients_together) {
+  RunningServer server;
+  // Eight clients, two to a table, with every table playing at once
+  const int clients = 8;
+  vector<string> transcripts(clients);
+  vector<int> played(clients, 0);
+  vector<thread> threads;
+  for (int c = 0; c < clients; ++c) {
+    threads.emplace_back([&, c] {
+      SimpleClient client;
+      if (client.connect(SOCKET_PATH)
+          && client.play("Pat", 2, transcripts[c])) {
+        played[c] = 1;
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  // Which client sat where is a race, but both seats are named Pat
+  vector<string> expected;
+  for (int table = 0; table < clients / 2; ++table) {
+    expected.push_back(
+        expected_transcript({"Pat", "Pat", "Bot2", "Bot3"}, table));
+  }
+  for (int c = 0; c < clients; ++c) {
+    ASSERT_EQUAL(played[c], 1);
+    ASSERT_TRUE(find(expected.begin(), expected.end(), transcripts[c])
+                != expected.end());
+  }
+}
+
+TEST(test_server_rejects_bad_lines) {
+  RunningServer server;
+  {
+    LineClient client;
+    client.send("HELLO");
+    ASSERT_EQUAL(client.read_line().compare(0, 6, "ERROR "), 0);
+    client.send("PLAY Ann 5");
+    ASSERT_EQUAL(client.read_line().compare(0, 6, "ERROR "), 0);
+    client.send("PLAY Ann 1");
+    ASSERT_EQUAL(client.read_line(), "SEATED 0 0");
+
+    // The seat deals first, so it bids unless the upcard was ordered up
+    client.read_until("HAND ");
+    const string ask = client.read_until("ASK ");
+    client.send("PLAY Ann 1");
+    ASSERT_EQUAL(client.read_line(), "ERROR already seated");
+    if (ask.compare(0, 10, "ASK BID 1 ") == 0) {
+      client.send("0");
+      ASSERT_EQUAL(client.read_line(), "ERROR expected pass or a suit");
+      // Only the upcard's suit may be ordered up in round 1
+      const string upcard_suit = ask.substr(ask.rfind(' ') + 1);
+      client.send(upcard_suit == "Spades" ? "Hearts" : "Spades");
+      ASSERT_EQUAL(client.read_line(), "ERROR not legal");
+    } else {
+      ASSERT_EQUAL(ask.compare(0, 12, "ASK DISCARD "), 0);
+      client.send("pass");
+      ASSERT_EQUAL(client.read_line(),
+                   "ERROR expected the position of a card");
+    }
+    client.send("5");
+    ASSERT_EQUAL(client.read_line().compare(0, 6, "ERROR "), 0);
+    // Leaving mid-game hands the seat to a Simple player
+  }
+
+  // Which plays the game out, and the server carries on
+  SimpleClient client;
+  ASSERT_TRUE(client.connect(SOCKET_PATH));
+  string transcript;
+  ASSERT_TRUE(client.play("Bob", 1, transcript));
+  ASSERT_EQUAL(transcript,
+               expected_transcript({"Bob", "Bot1", "Bot2", "Bot3"}, 1));
+}
+
+TEST(test_server_finishes_games_when_stopped) {
+  RunningServer server;
+  LineClient playing;
+  LineClient waiting;
+  playing.send("PLAY Ann 1");
+  ASSERT_EQUAL(playing.read_line(), "SEATED 0 0");
+  waiting.send("PLAY Bob 2");
+  ASSERT_EQUAL(waiting.read_line(), "SEATED 1 0");
+
+  // Stopped with a question open, the game is played out for the client
+  string transcript;
+  string line;
+  while ((line = playing.read_line()).compare(0, 4, "ASK ") != 0) {
+    if (line.compare(0, 4, "LOG ") == 0) {
+      transcript += line.substr(4) + "\n";
+    }
+  }
+  server.stop();
+  while ((line = playing.read_line()) != "DONE") {
+    if (line.compare(0, 4, "LOG ") == 0) {
+      transcript += line.substr(4) + "\n";
+    }
+  }
+  ASSERT_EQUAL(transcript,
+               expected_transcript({"Ann", "Bot1", "Bot2", "Bot3"}, 0));
+  // The table that never filled is not played
+  ASSERT_EQUAL(waiting.read_line(), "ERROR the server is stopping");
+}
+
+TEST_MAIN()
@@ -0,0 +1,159 @@
+// GameSink.cpp
+#include "GameSink.hpp"
+#include <cassert>
+
+using namespace std;
+
+/////////////// TextSink ///////////////
+
+TextSink::TextSink(ostream &os_in, const vector<string> &names_in)
+  : os(os_in), names(names_in) {
+  for (int team = 0; team < 2; ++team) {
+    teams[team] = names[team] + " and " + names[team + 2];
+  }
+}
+
+void TextSink::append_number(int n) {
+  assert(n >= 0);
+  char digits[12];
+  int count = 0;
+  do {
+    digits[count++] = static_cast<char>('0' + n % 10);
+    n /= 10;
+  } while (n > 0);
+  while (count > 0) {
+    text += digits[--count];
+  }
+}
+
+void TextSink::write_text() {
+  os.write(text.data(), text.size());
+  text.clear();
+}
+
+void TextSink::on_deal(const DealEvent &e) {
+  text += "Hand ";
+  append_number(e.hand_number);
+  text += '\n';
+  text += names[e.dealer];
+  text += " deals\n";
+  text += Card_name(e.upcard);
+  text += " turned up\n";
+  write_text();
+}
+
+void TextSink::on_bid(const BidEvent &e) {
+  text += names[e.seat];
+  if (e.order_up) {
+    text += " orders up ";
+    text += Suit_name(e.suit);
+    text += '\n';
+  } else {
+    text += " passes\n";
+  }
+  write_text();
+}
+
+// Extra newline when making/adding/discarding completes
+void TextSink::on_trump(const TrumpEvent &) {
+  os.put('\n');
+}
+
+void TextSink::on_play(const PlayEvent &e) {
+  text += Card_name(e.card);
+  text += e.lead ? " led by " : " played by ";
+  text += names[e.seat];
+  text += '\n';
+  write_text();
+}
+
+// Extra newline after each trick
+void TextSink::on_trick(const TrickEvent &e) {
+  text += names[e.winner];
+  text += " takes the trick\n\n";
+  write_text();
+}
+
+void TextSink::on_hand(const HandEvent &e) {
+  text += teams[e.tricks[0] > e.tricks[1] ? 0 : 1];
+  text += " win the hand\n";
+  if (e.march) {
+    text += "march!\n";
+  }
+  if (e.euchred) {
+    text += "euchred!\n";
+  }
+  for (int team = 0; team < 2; ++team) {
+    text += teams[team];
+    text += " have ";
+    append_number(e.points[team]);
+    text += " points\n";
+  }
+  text += '\n';
+  write_text();
+}
+
+void TextSink::on_game_over(const GameOverEvent &e) {
+  text += teams[e.winner];
+  text += " win!\n";
+  write_text();
+  os.flush();
+}
+
+/////////////// StatsSink ///////////////
+
+GameStats & GameStats::operator+=(const GameStats &other) {
+  team_wins[0] += other.team_wins[0];
+  team_wins[1] += other.team_wins[1];
+  hands += other.hands;
+  marches += other.marches;
+  euchres += other.euchres;
+  return *this;
+}
+
+void StatsSink::on_hand(const HandEvent &e) {
+  ++stats.hands;
+  stats.marches += e.march;
+  stats.euchres += e.euchred;
+}
+
+void StatsSink::on_game_over(const GameOverEvent &e) {
+  ++stats.team_wins[e.winner];
+}
+
+/////////////// TeeSink ///////////////
+
+void TeeSink::on_deal(const DealEvent &e) {
+  first.on_deal(e);
+  second.on_deal(e);
+}
+
+void TeeSink::on_bid(const BidEvent &e) {
+  first.on_bid(e);
+  second.on_bid(e);
+}
+
+void TeeSink::on_trump(const TrumpEvent &e) {
+  first.on_trump(e);
+  second.on_trump(e);
+}
+
+void TeeSink::on_play(const PlayEvent &e) {
+  first.on_play(e);
+  second.on_play(e);
+}
+
+void TeeSink::on_trick(const TrickEvent &e) {
+  first.on_trick(e);
+  second.on_trick(e);
+}
+
+void TeeSink::on_hand(const HandEvent &e) {
+  first.on_hand(e);
+  second.on_hand(e);
+}
+
+void TeeSink::on_game_over(const GameOverEvent &e) {
+  first.on_game_over(e);
+  second.on_game_over(e);
+}
@@ -0,0 +1,158 @@
+#ifndef GAME_SINK_HPP
+#define GAME_SINK_HPP
+/* GameSink.hpp
+ *
+ * Typed events emitted by Game, and the sinks that consume them
+ */
+
+#include "Card.hpp"
+#include "Hand.hpp"
+#include <array>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Seats are numbered 0 to 3; seats 0 and 2 are team 0, seats 1 and 3 are
+// team 1.
+
+// The cards have been dealt and the upcard turned
+struct DealEvent {
+  int hand_number;
+  int dealer;
+  Card upcard;
+  std::array<Hand, 4> hands; // the five cards dealt to each seat
+};
+
+// One seat passed or ordered up a suit
+struct BidEvent {
+  int seat;
+  int round;      // 1 or 2
+  bool order_up;
+  Suit suit;      // the suit ordered up, if order_up
+};
+
+// Bidding is over; in round 1 the dealer has picked up the upcard
+struct TrumpEvent {
+  int maker;
+  int round;
+  Suit trump;
+};
+
+// One card was led or played to a trick
+struct PlayEvent {
+  int seat;
+  Card card;
+  bool lead;
+};
+
+// The last card of a trick was played
+struct TrickEvent {
+  int trick;  // 0 to 4
+  int winner;
+};
+
+// All five tricks were played and the hand scored
+struct HandEvent {
+  int maker;
+  std::array<int, 2> tricks; // tricks taken by each team
+  std::array<int, 2> points; // game score after this hand
+  bool march;
+  bool euchred;
+};
+
+// A team reached the points needed to win
+struct GameOverEvent {
+  int winner; // winning team
+  std::array<int, 2> points;
+};
+
+// Receives the events of every hand a Game plays.  Every handler does
+// nothing by default, so GameSink itself is the null sink.
+class GameSink {
+public:
+  virtual void on_deal(const DealEvent &) {}
+  virtual void on_bid(const BidEvent &) {}
+  virtual void on_trump(const TrumpEvent &) {}
+  virtual void on_play(const PlayEvent &) {}
+  virtual void on_trick(const TrickEvent &) {}
+  virtual void on_hand(const HandEvent &) {}
+  virtual void on_game_over(const GameOverEvent &) {}
+
+  virtual ~GameSink() {}
+};
+
+// Writes the human-readable transcript required by the project spec.  Each
+// event is formatted into one reused string from precomputed card, suit
+// and team names, then written to the stream in one piece.  The stream is
+// flushed when the game is over.
+class TextSink : public GameSink {
+public:
+  //EFFECTS Initializes a sink that writes to os, naming seats by names
+  TextSink(std::ostream &os_in, const std::vector<std::string> &names_in);
+
+  void on_deal(const DealEvent &e) override;
+  void on_bid(const BidEvent &e) override;
+  void on_trump(const TrumpEvent &e) override;
+  void on_play(const PlayEvent &e) override;
+  void on_trick(const TrickEvent &e) override;
+  void on_hand(const HandEvent &e) override;
+  void on_game_over(const GameOverEvent &e) override;
+
+private:
+  std::ostream &os;
+  std::vector<std::string> names;
+  std::array<std::string, 2> teams; // "<partner> and <partner>"
+  std::string text;                 // the event being formatted
+
+  // REQUIRES: n >= 0
+  // Appends n in decimal to text
+  void append_number(int n);
+
+  // Writes text to os and clears it
+  void write_text();
+};
+
+// Totals over every game a StatsSink has seen
+struct GameStats {
+  std::array<long, 2> team_wins = {{0, 0}};
+  long hands = 0;
+  long marches = 0;
+  long euchres = 0;
+
+  GameStats & operator+=(const GameStats &other);
+};
+
+// Counts games, hands, marches and euchres
+class StatsSink : public GameSink {
+public:
+  void on_hand(const HandEvent &e) override;
+  void on_game_over(const GameOverEvent &e) override;
+
+  const GameStats & get_stats() const { return stats; }
+
+private:
+  GameStats stats;
+};
+
+// Forwards every event to two sinks, first then second
+class TeeSink : public GameSink {
+public:
+  //EFFECTS Initializes a sink that forwards to first_in and second_in,
+  //  which must outlive it
+  TeeSink(GameSink &first_in, GameSink &second_in)
+    : first(first_in), second(second_in) {}
+
+  void on_deal(const DealEvent &e) override;
+  void on_bid(const BidEvent &e) override;
+  void on_trump(const TrumpEvent &e) override;
+  void on_play(const PlayEvent &e) override;
+  void on_trick(const TrickEvent &e) override;
+  void on_hand(const HandEvent &e) override;
+  void on_game_over(const GameOverEvent &e) override;
+
+private:
+  GameSink &first;
+  GameSink &second;
+};
+
+#endif // GAME_SINK_HPP
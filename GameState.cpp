@@ -0,0 +1,51 @@
+// GameState.cpp
+#include "GameState.hpp"
+#include <cassert>
+
+using namespace std;
+
+void GameState::start_hand(Suit trump_in, int leader) {
+  trump = trump_in;
+  count = 0;
+  tricks = {{0, 0}};
+  leaders[0] = static_cast<unsigned char>(leader);
+}
+
+Hand GameState::legal() const {
+  const Hand hand = hands[to_play()];
+  return cards_in_trick() == 0 ? hand : legal_moves(hand, led(), trump);
+}
+
+int GameState::make_move(const Card &card) {
+  assert(!hand_over());
+  const int seat = to_play();
+  hands[seat].remove(card);
+  history[count++] = card;
+  if (count % 4 != 0) {
+    return -1;
+  }
+
+  const int first = count - 4;
+  int best = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (Card_less(history[first + best], history[first + i], history[first],
+                  trump)) {
+      best = i;
+    }
+  }
+  const int winner = (leaders[first / 4] + best) % 4;
+  leaders[count / 4] = static_cast<unsigned char>(winner);
+  ++tricks[winner % 2];
+  return winner;
+}
+
+void GameState::unmake_move() {
+  assert(count > 0);
+  const Card &card = history[--count];
+  const int trick = count / 4;
+  const int i = count % 4;
+  hands[(leaders[trick] + i) % 4].add(card);
+  if (i == 3) {
+    --tricks[leaders[trick + 1] % 2];
+  }
+}
@@ -0,0 +1,71 @@
+#ifndef GAME_STATE_HPP
+#define GAME_STATE_HPP
+/* GameState.hpp
+ *
+ * The cards, trick and scores of a game in one small copyable value, with
+ * moves made and unmade in place
+ */
+
+#include "Card.hpp"
+#include "Hand.hpp"
+#include <array>
+#include <type_traits>
+
+struct GameState {
+  static constexpr int TRICKS = 5;
+  static constexpr int CARDS = 4 * TRICKS; // cards played in a hand
+
+  std::array<Hand, 4> hands;           // cards each seat holds
+  std::array<Card, CARDS> history;     // cards played this hand, in order
+  std::array<unsigned char, TRICKS + 1> leaders; // seat leading each trick
+  std::array<unsigned char, 2> tricks; // tricks each team took this hand
+  std::array<int, 2> points;           // game points for each team
+  unsigned char count;                 // cards played this hand
+  Suit trump;
+
+  //MODIFIES this GameState
+  //EFFECTS Starts play of a hand with the cards now in hands: no cards
+  //  played, no tricks taken, and leader to lead.  Points are unchanged.
+  void start_hand(Suit trump_in, int leader);
+
+  //EFFECTS Returns the seat leading the current trick, or after the last
+  //  trick the seat that won it
+  int leader() const { return leaders[count / 4]; }
+
+  //EFFECTS Returns the number of tricks finished this hand
+  int trick_number() const { return count / 4; }
+
+  //EFFECTS Returns the cards played to the current trick
+  int cards_in_trick() const { return count % 4; }
+
+  //EFFECTS Returns the seat whose turn it is
+  int to_play() const { return (leader() + count % 4) % 4; }
+
+  //REQUIRES cards_in_trick() > 0
+  //EFFECTS Returns the card led to the current trick
+  const Card & led() const { return history[count - count % 4]; }
+
+  //EFFECTS Returns true once all five tricks are played
+  bool hand_over() const { return count == CARDS; }
+
+  //EFFECTS Returns the cards the seat to play may legally play
+  Hand legal() const;
+
+  //REQUIRES !hand_over() and the seat to play holds card
+  //MODIFIES this GameState
+  //EFFECTS Plays card for the seat to play.  If that completes the trick,
+  //  the winner takes it and leads next, and make_move returns the winner;
+  //  otherwise it returns -1.  O(1), no allocation.
+  int make_move(const Card &card);
+
+  //REQUIRES count > 0
+  //MODIFIES this GameState
+  //EFFECTS Takes back the last card played, restoring the state before
+  //  that make_move.  O(1), no allocation.
+  void unmake_move();
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value,
+              "GameState should copy with memcpy");
+
+#endif // GAME_STATE_HPP
@@ -0,0 +1,88 @@
+#include "GameState.hpp"
+#include "Pack.hpp"
+#include "Solver.hpp"
+#include "unit_test_framework.hpp"
+
+using namespace std;
+
+// A new hand dealt from a random shuffle, with leader to lead
+static GameState random_state(Rng &rng, Suit trump, int leader) {
+  Pack pack;
+  pack.shuffle(rng);
+  GameState state;
+  state.hands.fill(Hand());
+  for (int seat = 0; seat < 4; ++seat) {
+    for (int c = 0; c < GameState::TRICKS; ++c) {
+      state.hands[seat].add(pack.deal_one());
+    }
+  }
+  state.points = {{3, 7}};
+  state.start_hand(trump, leader);
+  return state;
+}
+
+static bool same_position(const GameState &a, const GameState &b) {
+  return a.hands == b.hands && a.tricks == b.tricks && a.count == b.count
+      && a.leader() == b.leader() && a.points == b.points;
+}
+
+TEST(test_game_state_matches_position) {
+  Rng rng(3);
+  for (int deal = 0; deal < 50; ++deal) {
+    GameState state = random_state(rng, static_cast<Suit>(deal % 4), deal % 4);
+    Position pos;
+    pos.hands = state.hands;
+    pos.trump = state.trump;
+    pos.leader = state.leader();
+    while (!state.hand_over()) {
+      ASSERT_EQUAL(state.to_play(), pos.to_play());
+      ASSERT_TRUE(state.legal() == pos.legal());
+      const Hand legal = state.legal();
+      uint32_t bits = legal.get_bits();
+      for (uint32_t skip = rng.below(legal.size()); skip > 0; --skip) {
+        bits &= bits - 1;
+      }
+      const Card card = Hand(bits & (0u - bits)).first();
+      ASSERT_EQUAL(state.make_move(card), pos.play(card));
+    }
+    ASSERT_EQUAL(state.tricks[0] + state.tricks[1], GameState::TRICKS);
+  }
+}
+
+TEST(test_game_state_unmake_restores) {
+  Rng rng(4);
+  for (int deal = 0; deal < 50; ++deal) {
+    GameState state = random_state(rng, static_cast<Suit>(deal % 4), deal % 4);
+    GameState before[GameState::CARDS];
+    while (!state.hand_over()) {
+      before[state.count] = state;
+      state.make_move(deal % 2 ? state.legal().first() : state.legal().last());
+    }
+    while (state.count > 0) {
+      state.unmake_move();
+      ASSERT_TRUE(same_position(state, before[state.count]));
+    }
+  }
+}
+
+TEST(test_game_state_unmake_trick_winner) {
+  GameState state;
+  state.hands = {{Hand::of(Card(NINE, SPADES)), Hand::of(Card(ACE, SPADES)),
+                  Hand::of(Card(NINE, HEARTS)), Hand::of(Card(TEN, SPADES))}};
+  state.points = {{0, 0}};
+  state.start_hand(HEARTS, 0);
+  state.make_move(Card(NINE, SPADES));
+  state.make_move(Card(ACE, SPADES));
+  state.make_move(Card(NINE, HEARTS));
+  ASSERT_EQUAL(state.make_move(Card(TEN, SPADES)), 2); // partner trumps
+  ASSERT_EQUAL(state.leader(), 2);
+  ASSERT_EQUAL(state.tricks[0], 1);
+
+  state.unmake_move();
+  ASSERT_EQUAL(state.leader(), 0);
+  ASSERT_EQUAL(state.tricks[0], 0);
+  ASSERT_EQUAL(state.to_play(), 3);
+  ASSERT_TRUE(state.hands[3].contains(Card(TEN, SPADES)));
+}
+
+TEST_MAIN()
@@ -0,0 +1,180 @@
+#include "Game.hpp"
+#include "unit_test_framework.hpp"
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+// Counts each kind of event
+class CountingSink : public GameSink {
+public:
+  int deals = 0;
+  int bids = 0;
+  int plays = 0;
+  int leads = 0;
+  int tricks = 0;
+  int hands = 0;
+  int games = 0;
+
+  void on_deal(const DealEvent &e) override {
+    ++deals;
+    for (const Hand &hand : e.hands) {
+      ASSERT_EQUAL(hand.size(), 5);
+    }
+  }
+  void on_bid(const BidEvent &) override { ++bids; }
+  void on_play(const PlayEvent &e) override {
+    ++plays;
+    leads += e.lead;
+  }
+  void on_trick(const TrickEvent &) override { ++tricks; }
+  void on_hand(const HandEvent &e) override {
+    ++hands;
+    ASSERT_EQUAL(e.tricks[0] + e.tricks[1], 5);
+  }
+  void on_game_over(const GameOverEvent &) override { ++games; }
+};
+
+static vector<Player*> simple_players() {
+  vector<Player*> players;
+  for (const char *name : {"Adi", "Barbara", "Chi-Chih", "Dabbala"}) {
+    players.push_back(Player_factory(name, "Simple"));
+  }
+  return players;
+}
+
+TEST(test_game_event_counts) {
+  Pack pack;
+  vector<Player*> players = simple_players();
+  CountingSink counts;
+  Game game(pack, true, 10, players);
+  game.set_sink(counts);
+  game.play();
+
+  ASSERT_EQUAL(counts.games, 1);
+  ASSERT_EQUAL(counts.deals, counts.hands);
+  ASSERT_EQUAL(counts.tricks, 5 * counts.hands);
+  ASSERT_EQUAL(counts.plays, 20 * counts.hands);
+  ASSERT_EQUAL(counts.leads, counts.tricks);
+  ASSERT_TRUE(counts.bids >= counts.hands);
+  for (Player *p : players) delete p;
+}
+
+// Game checks every card played is legal, so a finished game shows the
+// searching players only played cards they held and followed suit
+TEST(test_game_search_players_play_legally) {
+  Pack pack;
+  vector<Player*> players = simple_players();
+  delete players[0];
+  delete players[1];
+  delete players[2];
+  players[0] = Player_factory("Adi", "MonteCarlo:8");
+  players[1] = Player_factory("Barbara", "Ismcts:100");
+  players[2] = Player_factory("Chi-Chih", "MonteCarlo:8:2");
+  CountingSink counts;
+  Rng rng(7);
+  Game game(pack, true, 5, players);
+  game.set_sink(counts);
+  game.set_rng(&rng);
+  game.play();
+
+  ASSERT_EQUAL(counts.games, 1);
+  ASSERT_EQUAL(counts.plays, 20 * counts.hands);
+  for (Player *p : players) delete p;
+}
+
+TEST(test_game_text_transcript) {
+  Pack pack;
+  vector<Player*> players = simple_players();
+  ostringstream oss;
+  TextSink transcript(oss, {"Adi", "Barbara", "Chi-Chih", "Dabbala"});
+  Game game(pack, false, 1, players);
+  game.set_sink(transcript);
+  game.play();
+
+  // The golden transcript starts with the command line, which Game does
+  // not print
+  ifstream golden_file("euchre_test00.out.correct");
+  string command_line;
+  getline(golden_file, command_line);
+  ostringstream golden;
+  golden << golden_file.rdbuf();
+  ASSERT_EQUAL(oss.str(), golden.str());
+  for (Player *p : players) delete p;
+}
+
+TEST(test_game_stats) {
+  Pack pack;
+  vector<Player*> players = simple_players();
+  CountingSink counts;
+  StatsSink stats;
+  Game game(pack, false, 5, players);
+
+  game.set_sink(counts);
+  game.play();
+  game.set_sink(stats);
+  game.play();
+
+  // Replaying from the same Pack order gives the same game every time
+  ASSERT_EQUAL(stats.get_stats().hands, counts.hands);
+  ASSERT_EQUAL(stats.get_stats().team_wins[0] + stats.get_stats().team_wins[1],
+               1);
+  for (Player *p : players) delete p;
+}
+
+// Bids and plays as a Simple player, but leads a card it does not hold
+class Cheat : public Player {
+public:
+  explicit Cheat(const string &name) : simple(Player_factory(name, "Simple")) {}
+  ~Cheat() { delete simple; }
+
+  const string & get_name() const override { return simple->get_name(); }
+  void add_card(const Card &c) override {
+    hand.add(c);
+    simple->add_card(c);
+  }
+  bool make_trump(const Card &upcard, bool is_dealer, int round,
+                  Suit &order_up_suit) const override {
+    return simple->make_trump(upcard, is_dealer, round, order_up_suit);
+  }
+  Card add_and_discard(const Card &upcard) override {
+    const Card discard = simple->add_and_discard(upcard);
+    hand.add(upcard);
+    hand.remove(discard);
+    return discard;
+  }
+  Card lead_card(Suit) override {
+    return Hand::full().without(hand).first();
+  }
+  Card play_card(const Card &led_card, Suit trump) override {
+    const Card played = simple->play_card(led_card, trump);
+    hand.remove(played);
+    return played;
+  }
+
+private:
+  Player *simple;
+  Hand hand;
+};
+
+// Game checks plays in every build, not just with asserts on
+TEST(test_game_rejects_illegal_lead) {
+  vector<Player*> players;
+  for (const char *name : {"Adi", "Barbara", "Chi-Chih", "Dabbala"}) {
+    players.push_back(new Cheat(name));
+  }
+  Pack pack;
+  Game game(pack, false, 5, players);
+  string message;
+  try {
+    game.play();
+  } catch (const logic_error &e) {
+    message = e.what();
+  }
+  // Barbara sits left of the first dealer, so leads first
+  ASSERT_EQUAL(message.compare(0, 16, "Barbara led Nine"), 0);
+  for (Player *p : players) delete p;
+}
+
+TEST_MAIN()
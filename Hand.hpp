@@ -0,0 +1,195 @@
+#ifndef HAND_HPP
+#define HAND_HPP
+/* Hand.hpp
+ *
+ * Represents a set of euchre cards (Nine through Ace) as a 24-bit mask
+ */
+
+#include "Card.hpp"
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+// Bit i of a Hand holds the card whose index is i + Hand::FIRST_INDEX.
+// Because card indices follow operator< (rank, then suit), bit order is the
+// plain card order, and every card of one suit sits four bits apart.
+class Hand {
+public:
+  // Number of cards in a euchre pack
+  static const int NUM_CARDS = 24;
+
+  // Card index of the lowest euchre card, the Nine of Spades
+  static const int FIRST_INDEX = NINE * (DIAMONDS + 1) + SPADES;
+
+  //EFFECTS Initializes an empty Hand
+  constexpr Hand() : bits(0) {}
+
+  //REQUIRES bits_in only uses the low NUM_CARDS bits
+  //EFFECTS Initializes Hand from a raw mask
+  explicit constexpr Hand(uint32_t bits_in) : bits(bits_in) {}
+
+  //EFFECTS Returns the Hand holding only c, or the empty Hand if c is
+  //  below Nine, as no Hand holds such a card
+  static constexpr Hand of(const Card &c) {
+    // Shifting down instead of by index - FIRST_INDEX drops the low cards
+    // without shifting by a negative amount, and without a branch
+    return Hand(static_cast<uint32_t>((uint64_t(1) << c.get_index())
+                                      >> FIRST_INDEX));
+  }
+
+  //EFFECTS Returns the Hand holding all NUM_CARDS euchre cards
+  static constexpr Hand full() {
+    return Hand((uint32_t(1) << NUM_CARDS) - 1);
+  }
+
+  //EFFECTS Returns the Hand holding every card of the given suit, with the
+  //  left bower moved into the trump suit
+  static constexpr Hand suit_cards(Suit suit, Suit trump) {
+    const Hand left = of(Card(JACK, Suit_next(trump)));
+    const Hand plain(SUIT_BITS << suit);
+    if (suit == trump) {
+      return plain | left;
+    }
+    return suit == Suit_next(trump) ? plain.without(left) : plain;
+  }
+
+  //EFFECTS Returns the raw mask
+  constexpr uint32_t get_bits() const { return bits; }
+
+  //EFFECTS Returns true if the Hand holds no cards
+  constexpr bool empty() const { return bits == 0; }
+
+  //EFFECTS Returns the number of cards in the Hand
+  constexpr int size() const { return __builtin_popcount(bits); }
+
+  //EFFECTS Returns true if the Hand holds c, so false if c is below Nine
+  constexpr bool contains(const Card &c) const {
+    return !(*this & of(c)).empty();
+  }
+
+  //REQUIRES c is Nine through Ace and not already in the Hand
+  //MODIFIES this Hand
+  //EFFECTS Adds c
+  void add(const Card &c) {
+    assert(c.get_rank() >= NINE && !contains(c));
+    bits |= of(c).bits;
+  }
+
+  //REQUIRES the Hand holds c
+  //MODIFIES this Hand
+  //EFFECTS Removes c
+  void remove(const Card &c) {
+    assert(contains(c));
+    bits &= ~of(c).bits;
+  }
+
+  //EFFECTS Returns the cards of this Hand that are not in other
+  constexpr Hand without(Hand other) const { return Hand(bits & ~other.bits); }
+
+  //EFFECTS Returns the cards of this Hand whose get_suit(trump) is suit
+  constexpr Hand in_suit(Suit suit, Suit trump) const {
+    return *this & suit_cards(suit, trump);
+  }
+
+  //EFFECTS Returns the trump cards of this Hand, including the left bower
+  constexpr Hand trump_cards(Suit trump) const {
+    return in_suit(trump, trump);
+  }
+
+  //EFFECTS Returns the Jacks, Queens, Kings and Aces of this Hand
+  constexpr Hand face_or_ace() const { return Hand(bits & FACE_BITS); }
+
+  //REQUIRES Hand is not empty
+  //EFFECTS Returns the lowest card by operator<
+  constexpr Card first() const {
+    return Card::from_index(FIRST_INDEX + __builtin_ctz(bits));
+  }
+
+  //REQUIRES Hand is not empty
+  //EFFECTS Returns the highest card by operator<
+  constexpr Card last() const {
+    return Card::from_index(FIRST_INDEX + 31 - __builtin_clz(bits));
+  }
+
+  //REQUIRES Hand is not empty
+  //EFFECTS Returns the highest card by Card_less(a, b, trump)
+  constexpr Card highest(Suit trump) const {
+    const Card right(JACK, trump);
+    const Card left(JACK, Suit_next(trump));
+    if (contains(right)) {
+      return right;
+    }
+    if (contains(left)) {
+      return left;
+    }
+    const Hand trumps = trump_cards(trump);
+    return trumps.empty() ? last() : trumps.last();
+  }
+
+  //REQUIRES Hand is not empty
+  //EFFECTS Returns the lowest card by Card_less(a, b, trump)
+  constexpr Card lowest(Suit trump) const {
+    const Card right(JACK, trump);
+    const Card left(JACK, Suit_next(trump));
+    const Hand rest = without(of(right) | of(left));
+    if (!rest.empty()) {
+      const Hand plain = rest.without(rest.trump_cards(trump));
+      return plain.empty() ? rest.first() : plain.first();
+    }
+    return contains(left) ? left : right;
+  }
+
+  //REQUIRES map is a permutation of the four suits
+  //EFFECTS Returns this hand with the suit of every card s replaced by
+  //  map[s], the rank unchanged
+  constexpr Hand with_suits(const std::array<Suit, 4> &map) const {
+    uint32_t out = 0;
+    for (int s = SPADES; s <= DIAMONDS; ++s) {
+      const uint32_t column = bits & (SUIT_BITS << s);
+      out |= map[s] >= s ? column << (map[s] - s) : column >> (s - map[s]);
+    }
+    return Hand(out);
+  }
+
+  friend constexpr Hand operator&(Hand lhs, Hand rhs) {
+    return Hand(lhs.bits & rhs.bits);
+  }
+
+  friend constexpr Hand operator|(Hand lhs, Hand rhs) {
+    return Hand(lhs.bits | rhs.bits);
+  }
+
+  friend constexpr bool operator==(Hand lhs, Hand rhs) {
+    return lhs.bits == rhs.bits;
+  }
+
+  friend constexpr bool operator!=(Hand lhs, Hand rhs) {
+    return lhs.bits != rhs.bits;
+  }
+
+private:
+  // One bit per rank for the Spades column; shift left by a suit to select it
+  static const uint32_t SUIT_BITS = 0x111111;
+
+  // Jack, Queen, King and Ace of every suit
+  static const uint32_t FACE_BITS = 0xFFFF00;
+
+  uint32_t bits;
+};
+
+//EFFECTS Returns the cards of hand that may be played to a trick led by
+//  led_card: the cards of the led suit (the left bower counts as trump), or
+//  the whole hand when it cannot follow suit.
+constexpr Hand legal_moves(Hand hand, const Card &led_card, Suit trump) {
+  const uint32_t follow =
+      hand.in_suit(led_card.get_suit(trump), trump).get_bits();
+  // All ones when the hand can follow suit, zero otherwise
+  const uint32_t can_follow = 0u - static_cast<uint32_t>(follow != 0);
+  return Hand(follow | (hand.get_bits() & ~can_follow));
+}
+
+static_assert(Hand::FIRST_INDEX + Hand::NUM_CARDS == Card::NUM_INDICES,
+              "euchre cards are the top indices");
+static_assert(Card::NUM_INDICES <= 64, "Hand::of shifts a 64-bit one");
+
+#endif // HAND_HPP
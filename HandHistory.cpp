@@ -0,0 +1,389 @@
+// HandHistory.cpp
+#include "HandHistory.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// The history file starts with this, then holds HandEntry after HandEntry.
+// It is as long as an entry, so entries stay aligned in the mapping.
+struct HandHistoryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t entry_size;
+  uint64_t reserved[2];
+};
+
+// The index file starts with this, then holds the game starts, the deal
+// positions, the marches and the euchres
+struct HandIndexHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t entries;
+  uint64_t games;
+  uint64_t marches;
+  uint64_t euchres;
+};
+
+static_assert(sizeof(HandHistoryHeader) == sizeof(HandEntry),
+              "entries should stay aligned");
+
+static const char MAGIC[8] = {'E', 'U', 'C', 'H', 'R', 'E', 'H', 'H'};
+static const char INDEX_MAGIC[8] = {'E', 'U', 'C', 'H', 'R', 'E', 'H', 'I'};
+static const uint32_t VERSION = 1;
+
+// Bits of a packed hand that hold its deal_index
+static const int DEAL_BITS = 49;
+
+uint64_t HandEntry::deal() const {
+  uint64_t bits = 0;
+  for (int i = 0; i < 7; ++i) {
+    bits |= uint64_t(hand[i]) << (8 * i);
+  }
+  return bits & ((uint64_t(1) << DEAL_BITS) - 1);
+}
+
+bool HandEntry::record(HandRecord &record) const {
+  return unpack_hand(hand.data(), hand_number % 4, record);
+}
+
+bool HandQuery::matches(const HandEntry &entry) const {
+  return (game_id < 0 || entry.game_id == uint64_t(game_id))
+         && (deal < 0 || entry.deal() == uint64_t(deal))
+         && entry.has(flags);
+}
+
+/////////////// HandHistoryWriter ///////////////
+
+HandHistoryWriter::~HandHistoryWriter() {
+  if (fd >= 0) {
+    ::close(fd);
+  }
+}
+
+// Writes all size bytes of data to fd, returning false on error
+static bool write_all(int fd, const void *data, size_t size) {
+  const char *next = static_cast<const char *>(data);
+  while (size > 0) {
+    const ssize_t written = ::write(fd, next, size);
+    if (written < 0) {
+      return false;
+    }
+    next += written;
+    size -= written;
+  }
+  return true;
+}
+
+bool HandHistoryWriter::open(const string &path) {
+  assert(fd < 0);
+  const int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+  if (file < 0) {
+    return false;
+  }
+  struct stat st;
+  bool ok = fstat(file, &st) == 0;
+  HandHistoryHeader header;
+  if (ok && st.st_size == 0) {
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.entry_size = sizeof(HandEntry);
+    ok = write_all(file, &header, sizeof(header));
+  } else if (ok) {
+    ok = pread(file, &header, sizeof(header), 0) == sizeof(header)
+         && memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+         && header.version == VERSION
+         && header.entry_size == sizeof(HandEntry);
+  }
+
+  // Drop a hand left partly written and the rest of a game a writer
+  // stopped partway through, and carry on after the last whole game
+  size_t complete = ok && st.st_size > 0
+      ? (st.st_size - sizeof(header)) / sizeof(HandEntry) : 0;
+  HandEntry last;
+  while (ok && complete > 0) {
+    const off_t offset = sizeof(header) + (complete - 1) * sizeof(HandEntry);
+    ok = pread(file, &last, sizeof(last), offset) == sizeof(last);
+    if (ok && last.has(HandEntry::LAST_HAND)) {
+      next_game = last.game_id + 1;
+      break;
+    }
+    --complete;
+  }
+  if (ok && st.st_size > 0) {
+    ok = ftruncate(file, sizeof(header) + complete * sizeof(HandEntry)) == 0;
+  }
+  if (!ok) {
+    ::close(file);
+    return false;
+  }
+  fd = file;
+  return true;
+}
+
+// Keeps what each hand of a replayed game came to
+class OutcomeSink : public GameSink {
+public:
+  explicit OutcomeSink(vector<HandEntry> &entries_in) : entries(entries_in) {}
+
+  void on_deal(const DealEvent &e) override {
+    entries.emplace_back();
+    entries.back().hand_number = e.hand_number;
+  }
+
+  void on_trump(const TrumpEvent &e) override {
+    entries.back().maker = e.maker + 4 * e.round;
+  }
+
+  void on_hand(const HandEvent &e) override {
+    entries.back().outcome = e.tricks[e.maker % 2]
+                             | (e.march ? HandEntry::MARCH : 0)
+                             | (e.euchred ? HandEntry::EUCHRED : 0);
+  }
+
+  void on_game_over(const GameOverEvent &) override {
+    entries.back().outcome |= HandEntry::LAST_HAND;
+  }
+
+private:
+  vector<HandEntry> &entries;
+};
+
+bool HandHistoryWriter::append(const GameRecord &record) {
+  assert(fd >= 0);
+  vector<HandEntry> entries;
+  OutcomeSink outcomes(entries);
+  replay_game(record, outcomes);
+  assert(entries.size() == record.hands.size());
+  for (size_t h = 0; h < entries.size(); ++h) {
+    entries[h].game_id = next_game;
+    pack_hand(record.hands[h], entries[h].hand.data());
+  }
+  if (!write_all(fd, entries.data(), entries.size() * sizeof(HandEntry))) {
+    return false;
+  }
+  ++next_game;
+  return true;
+}
+
+/////////////// HandHistory ///////////////
+
+HandHistory::~HandHistory() {
+  if (mapping) {
+    munmap(mapping, mapping_size);
+  }
+  if (index_mapping) {
+    munmap(index_mapping, index_mapping_size);
+  }
+}
+
+// Maps the file at path read-only, setting size.  Returns MAP_FAILED if it
+// cannot, or it is shorter than min_size.
+static void * map_file(const string &path, size_t min_size, size_t &size) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return MAP_FAILED;
+  }
+  struct stat st;
+  void *base = MAP_FAILED;
+  size = fstat(fd, &st) == 0 ? st.st_size : 0;
+  if (size >= min_size && size > 0) {
+    base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  ::close(fd);
+  return base;
+}
+
+bool HandHistory::open(const string &path) {
+  assert(!mapping);
+  size_t size;
+  void *base = map_file(path, sizeof(HandHistoryHeader), size);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+  HandHistoryHeader header;
+  memcpy(&header, base, sizeof(header));
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+      || header.version != VERSION
+      || header.entry_size != sizeof(HandEntry)) {
+    munmap(base, size);
+    return false;
+  }
+  mapping = base;
+  mapping_size = size;
+  entries = reinterpret_cast<const HandEntry *>(
+      static_cast<const char *>(base) + sizeof(header));
+  num_entries = (size - sizeof(header)) / sizeof(HandEntry);
+  open_index(index_path(path));
+  return true;
+}
+
+string HandHistory::index_path(const string &path) {
+  return path + ".idx";
+}
+
+bool HandHistory::open_index(const string &path) {
+  size_t size;
+  void *base = map_file(path, sizeof(HandIndexHeader), size);
+  if (base == MAP_FAILED) {
+    return false;
+  }
+  HandIndexHeader header;
+  memcpy(&header, base, sizeof(header));
+  const uint64_t *sections = reinterpret_cast<const uint64_t *>(
+      static_cast<const char *>(base) + sizeof(header));
+  const size_t words = header.games + 1 + 2 * header.entries
+                       + header.marches + header.euchres;
+  bool ok = memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0
+            && header.version == VERSION && header.entries <= num_entries
+            && size == sizeof(header) + words * sizeof(uint64_t);
+
+  // The index must describe the hands now at the start of the history
+  ok = ok && sections[header.games] == header.entries
+       && (header.entries == 0
+           || entries[header.entries - 1].game_id + 1 == header.games);
+  if (!ok) {
+    munmap(base, size);
+    return false;
+  }
+  index_mapping = base;
+  index_mapping_size = size;
+  index.entries = header.entries;
+  index.games = header.games;
+  index.game_starts = sections;
+  index.deals = reinterpret_cast<const DealPosition *>(
+      sections + header.games + 1);
+  index.marches = sections + header.games + 1 + 2 * header.entries;
+  index.num_marches = header.marches;
+  index.euchres = index.marches + header.marches;
+  index.num_euchres = header.euchres;
+  return true;
+}
+
+bool HandHistory::build_index(const string &path) {
+  HandHistory history;
+  if (!history.open(path)) {
+    return false;
+  }
+  vector<uint64_t> game_starts;
+  vector<DealPosition> deals;
+  vector<uint64_t> marches;
+  vector<uint64_t> euchres;
+  for (size_t i = 0; i < history.size(); ++i) {
+    const HandEntry &entry = history[i];
+    if (entry.game_id == game_starts.size()) {
+      game_starts.push_back(i);
+    } else if (entry.game_id + 1 != game_starts.size()) {
+      return false; // games are numbered in order as they are appended
+    }
+    deals.push_back({entry.deal(), i});
+    if (entry.has(HandEntry::MARCH)) {
+      marches.push_back(i);
+    }
+    if (entry.has(HandEntry::EUCHRED)) {
+      euchres.push_back(i);
+    }
+  }
+  HandIndexHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+  header.version = VERSION;
+  header.entries = history.size();
+  header.games = game_starts.size();
+  header.marches = marches.size();
+  header.euchres = euchres.size();
+  game_starts.push_back(history.size());
+  sort(deals.begin(), deals.end(),
+       [](const DealPosition &a, const DealPosition &b) {
+    return a.deal < b.deal || (a.deal == b.deal && a.position < b.position);
+  });
+
+  // Readers may have the old index mapped, so replace it whole
+  const string index = index_path(path);
+  const string temporary = index + ".tmp";
+  FILE *out = fopen(temporary.c_str(), "wb");
+  if (!out) {
+    return false;
+  }
+  bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+  ok = ok && fwrite(game_starts.data(), sizeof(uint64_t), game_starts.size(),
+                    out) == game_starts.size();
+  ok = ok && fwrite(deals.data(), sizeof(DealPosition), deals.size(), out)
+                 == deals.size();
+  ok = ok && fwrite(marches.data(), sizeof(uint64_t), marches.size(), out)
+                 == marches.size();
+  ok = ok && fwrite(euchres.data(), sizeof(uint64_t), euchres.size(), out)
+                 == euchres.size();
+  ok = fclose(out) == 0 && ok;
+  return ok && rename(temporary.c_str(), index.c_str()) == 0;
+}
+
+void HandHistory::scan(const HandQuery &query, size_t begin, size_t end,
+                       vector<size_t> &found) const {
+  for (size_t i = begin; i < end; ++i) {
+    if (query.matches(entries[i])) {
+      found.push_back(i);
+    }
+  }
+}
+
+vector<size_t> HandHistory::find(const HandQuery &query) const {
+  vector<size_t> found;
+  if (query.game_id >= 0) {
+    // Games are stored whole and in order
+    const uint64_t game = query.game_id;
+    if (game < index.games) {
+      scan(query, index.game_starts[game], index.game_starts[game + 1],
+           found);
+    } else {
+      const HandEntry *first = lower_bound(
+          entries + index.entries, end(), game,
+          [](const HandEntry &entry, uint64_t id) {
+        return entry.game_id < id;
+      });
+      const HandEntry *last = upper_bound(
+          first, end(), game, [](uint64_t id, const HandEntry &entry) {
+        return id < entry.game_id;
+      });
+      scan(query, first - entries, last - entries, found);
+    }
+    return found;
+  }
+
+  // Otherwise look up the indexed hands by whichever field the query sets,
+  // then scan the hands after them
+  const bool by_deal = query.deal >= 0;
+  const bool by_march = !by_deal && (query.flags & HandEntry::MARCH);
+  const bool by_euchre = !by_deal && !by_march
+                         && (query.flags & HandEntry::EUCHRED);
+  if (by_deal) {
+    const DealPosition *deals_end = index.deals + index.entries;
+    const DealPosition *match = lower_bound(
+        index.deals, deals_end, uint64_t(query.deal),
+        [](const DealPosition &entry, uint64_t deal) {
+      return entry.deal < deal;
+    });
+    for (; match != deals_end && match->deal == uint64_t(query.deal);
+         ++match) {
+      scan(query, match->position, match->position + 1, found);
+    }
+  } else if (by_march || by_euchre) {
+    const uint64_t *positions = by_march ? index.marches : index.euchres;
+    const size_t count = by_march ? index.num_marches : index.num_euchres;
+    for (size_t i = 0; i < count; ++i) {
+      scan(query, positions[i], positions[i] + 1, found);
+    }
+  } else {
+    scan(query, 0, index.entries, found);
+  }
+  scan(query, index.entries, num_entries, found);
+  return found;
+}
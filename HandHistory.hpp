@@ -0,0 +1,157 @@
+#ifndef HAND_HISTORY_HPP
+#define HAND_HISTORY_HPP
+/* HandHistory.hpp
+ *
+ * An append-only file of every hand of many recorded games, read through
+ * a memory mapping, with a sidecar index for finding hands by game, by
+ * deal and by outcome
+ */
+
+#include "GameRecord.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// One hand as it is stored in the file, and read in place
+struct HandEntry {
+  // Flags in outcome
+  static const uint8_t MARCH = 1 << 3;
+  static const uint8_t EUCHRED = 1 << 4;
+  static const uint8_t LAST_HAND = 1 << 5; // the game ended on this hand
+
+  uint64_t game_id;
+  uint16_t hand_number;
+  uint8_t maker;   // the maker's seat, plus 4 times the round trump was
+                   // made in (0 if everyone passed)
+  uint8_t outcome; // tricks the maker's team took in the low 3 bits, then
+                   // the flags above
+  std::array<unsigned char, HAND_RECORD_BYTES> hand; // as pack_hand packs it
+
+  int maker_seat() const { return maker & 3; }
+  int round() const { return maker >> 2; }
+  int maker_tricks() const { return outcome & 7; }
+  bool has(uint8_t flags) const { return (outcome & flags) == flags; }
+
+  //EFFECTS Returns the deal_index of the hand's deal
+  uint64_t deal() const;
+
+  //MODIFIES record
+  //EFFECTS Unpacks the hand into record, returning false if it is not
+  //  well-formed
+  bool record(HandRecord &record) const;
+};
+
+static_assert(sizeof(HandEntry) == 32, "HandEntry should pack to 32 bytes");
+static_assert(std::is_trivially_copyable<HandEntry>::value,
+              "HandEntry is read in place from the file");
+
+// Appends games to a history file.  Only one writer may append to a file
+// at a time; readers may map it meanwhile.
+class HandHistoryWriter {
+public:
+  HandHistoryWriter() = default;
+  HandHistoryWriter(const HandHistoryWriter &) = delete;
+  HandHistoryWriter & operator=(const HandHistoryWriter &) = delete;
+  ~HandHistoryWriter();
+
+  //MODIFIES this HandHistoryWriter
+  //EFFECTS Opens the history file at path for appending, creating it if
+  //  there is none, and drops any game a writer left unfinished.  Returns
+  //  false if it cannot be opened or is not a history file.
+  bool open(const std::string &path);
+
+  //REQUIRES the writer is open and record is as for replay_game
+  //EFFECTS Appends every hand of record as game next_game_id(), replaying
+  //  it to find each hand's outcome.  Returns false on error.
+  bool append(const GameRecord &record);
+
+  //EFFECTS Returns the id the next game appended gets
+  uint64_t next_game_id() const { return next_game; }
+
+private:
+  int fd = -1;
+  uint64_t next_game = 0;
+};
+
+// What to look for in a history.  Every field that is set must match.
+struct HandQuery {
+  int64_t game_id = -1; // -1 for any game
+  int64_t deal = -1;    // a deal_index, or -1 for any deal
+  uint8_t flags = 0;    // HandEntry flags that must all be set
+
+  //EFFECTS Returns true if entry matches
+  bool matches(const HandEntry &entry) const;
+};
+
+// A history file mapped read-only.  Entries are read in place: iterating
+// from begin() to end() copies and allocates nothing.
+class HandHistory {
+public:
+  HandHistory() = default;
+  HandHistory(const HandHistory &) = delete;
+  HandHistory & operator=(const HandHistory &) = delete;
+  ~HandHistory();
+
+  //MODIFIES this HandHistory
+  //EFFECTS Maps the history file at path, and its index at
+  //  index_path(path) if that is current.  Hands appended after the index
+  //  was built are searched without it.  A hand only partly written is
+  //  left out.  Returns false if the file cannot be opened or is not a
+  //  history file.
+  bool open(const std::string &path);
+
+  //EFFECTS Returns the path of the index for the history at path
+  static std::string index_path(const std::string &path);
+
+  //EFFECTS Builds the index for the history at path, covering every hand
+  //  in it now.  Returns false on error.
+  static bool build_index(const std::string &path);
+
+  const HandEntry * begin() const { return entries; }
+  const HandEntry * end() const { return entries + num_entries; }
+  size_t size() const { return num_entries; }
+  const HandEntry & operator[](size_t i) const { return entries[i]; }
+
+  //EFFECTS Returns how many hands the index covers, 0 if it was not found
+  size_t indexed() const { return index.entries; }
+
+  //EFFECTS Returns the positions of the hands matching query, in order
+  std::vector<size_t> find(const HandQuery &query) const;
+
+private:
+  struct DealPosition {
+    uint64_t deal;
+    uint64_t position;
+  };
+
+  // Sections of the mapped index
+  struct Index {
+    size_t entries = 0;
+    size_t games = 0;
+    const uint64_t *game_starts = nullptr; // games + 1 entry positions
+    const DealPosition *deals = nullptr;   // one per entry, sorted
+    const uint64_t *marches = nullptr;     // positions of marches
+    size_t num_marches = 0;
+    const uint64_t *euchres = nullptr;     // positions of euchres
+    size_t num_euchres = 0;
+  };
+
+  const HandEntry *entries = nullptr;
+  size_t num_entries = 0;
+  void *mapping = nullptr;
+  size_t mapping_size = 0;
+  Index index;
+  void *index_mapping = nullptr;
+  size_t index_mapping_size = 0;
+
+  bool open_index(const std::string &path);
+
+  // Adds to found the positions from begin to end that match query
+  void scan(const HandQuery &query, size_t begin, size_t end,
+            std::vector<size_t> &found) const;
+};
+
+#endif // HAND_HISTORY_HPP
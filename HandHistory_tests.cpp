@@ -0,0 +1,196 @@
+#include "HandHistory.hpp"
+#include "Game.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+static const char *const HISTORY_FILE = "HandHistory_tests.hh";
+
+static void remove_history() {
+  remove(HISTORY_FILE);
+  remove(HandHistory::index_path(HISTORY_FILE).c_str());
+}
+
+// Records games of Simple players, each shuffled from its own stream
+static vector<GameRecord> record_games(int games, uint64_t seed) {
+  const vector<string> names = {"Ann", "Bob", "Cat", "Dan"};
+  vector<GameRecord> records;
+  for (int g = 0; g < games; ++g) {
+    vector<Player*> players;
+    for (const string &name : names) {
+      players.push_back(Player_factory(name, "Simple"));
+    }
+    ostringstream out;
+    RecordSink recorder(out, names, 10);
+    Rng rng(seed, g);
+    Pack pack;
+    Game game(pack, true, 10, players);
+    game.set_sink(recorder);
+    game.set_rng(&rng);
+    game.play();
+    for (Player *p : players) delete p;
+
+    istringstream in(out.str());
+    records.emplace_back();
+    ASSERT_EQUAL(read_game_record(in, records.back()), READ_OK);
+  }
+  return records;
+}
+
+static void append_games(const vector<GameRecord> &records) {
+  HandHistoryWriter writer;
+  ASSERT_TRUE(writer.open(HISTORY_FILE));
+  for (const GameRecord &record : records) {
+    ASSERT_TRUE(writer.append(record));
+  }
+}
+
+// Finds the hands matching query by looking at every one
+static vector<size_t> find_by_scanning(const HandHistory &history,
+                                       const HandQuery &query) {
+  vector<size_t> found;
+  for (const HandEntry &entry : history) {
+    if (query.matches(entry)) {
+      found.push_back(&entry - history.begin());
+    }
+  }
+  return found;
+}
+
+// Checks find against a scan for a spread of queries
+static void check_queries(const HandHistory &history) {
+  vector<HandQuery> queries(6);
+  queries[0].game_id = 3;
+  queries[1].game_id = 1000; // past the last game
+  queries[2].deal = history[history.size() / 2].deal();
+  queries[3].flags = HandEntry::MARCH;
+  queries[4].flags = HandEntry::EUCHRED | HandEntry::LAST_HAND;
+  queries[5].game_id = 7;
+  queries[5].flags = HandEntry::LAST_HAND;
+  for (const HandQuery &query : queries) {
+    ASSERT_TRUE(history.find(query) == find_by_scanning(history, query));
+  }
+  ASSERT_EQUAL(history.find(queries[5]).size(), 1u);
+  ASSERT_TRUE(history.find(HandQuery()).size() == history.size());
+}
+
+TEST(test_history_holds_every_hand_in_place) {
+  remove_history();
+  const vector<GameRecord> records = record_games(10, 1);
+  append_games(records);
+
+  HandHistory history;
+  ASSERT_TRUE(history.open(HISTORY_FILE));
+  ASSERT_EQUAL(history.indexed(), 0u);
+  size_t i = 0;
+  for (size_t g = 0; g < records.size(); ++g) {
+    for (size_t h = 0; h < records[g].hands.size(); ++h, ++i) {
+      const HandEntry &entry = history[i];
+      const HandRecord &expected = records[g].hands[h];
+      ASSERT_EQUAL(entry.game_id, g);
+      ASSERT_EQUAL(entry.hand_number, h);
+      ASSERT_EQUAL(entry.has(HandEntry::LAST_HAND),
+                   h + 1 == records[g].hands.size());
+      ASSERT_EQUAL(entry.deal(), deal_index(expected.dealt, expected.upcard));
+      HandRecord read;
+      ASSERT_TRUE(entry.record(read));
+      ASSERT_TRUE(read.dealt == expected.dealt);
+      ASSERT_TRUE(read.plays == expected.plays);
+      ASSERT_EQUAL(read.trump, expected.trump);
+      ASSERT_TRUE(entry.maker_tricks() <= 5);
+      ASSERT_EQUAL(entry.has(HandEntry::MARCH), entry.maker_tricks() == 5);
+      ASSERT_EQUAL(entry.has(HandEntry::EUCHRED), entry.maker_tricks() < 3);
+    }
+  }
+  ASSERT_EQUAL(history.size(), i);
+  remove_history();
+}
+
+TEST(test_history_find_with_and_without_index) {
+  remove_history();
+  append_games(record_games(12, 2));
+  {
+    HandHistory history;
+    ASSERT_TRUE(history.open(HISTORY_FILE));
+    check_queries(history);
+  }
+
+  // Indexed, then with more games appended after the index was built
+  ASSERT_TRUE(HandHistory::build_index(HISTORY_FILE));
+  {
+    HandHistory history;
+    ASSERT_TRUE(history.open(HISTORY_FILE));
+    ASSERT_EQUAL(history.indexed(), history.size());
+    check_queries(history);
+  }
+  append_games(record_games(5, 3));
+  {
+    HandHistory history;
+    ASSERT_TRUE(history.open(HISTORY_FILE));
+    ASSERT_TRUE(history.indexed() < history.size());
+    ASSERT_EQUAL(history[history.size() - 1].game_id, 16u);
+    check_queries(history);
+    HandQuery late;
+    late.game_id = 14;
+    ASSERT_TRUE(!history.find(late).empty());
+  }
+  remove_history();
+}
+
+TEST(test_history_drops_partly_written_game) {
+  remove_history();
+  append_games(record_games(2, 4));
+  size_t hands;
+  vector<HandEntry> unfinished;
+  {
+    HandHistory history;
+    ASSERT_TRUE(history.open(HISTORY_FILE));
+    hands = history.size();
+    // The first two hands of a third game, which never finished
+    unfinished.assign(history.begin(), history.begin() + 2);
+  }
+  {
+    ofstream torn(HISTORY_FILE, ios::binary | ios::app);
+    for (HandEntry &entry : unfinished) {
+      entry.game_id = 2;
+      torn.write(reinterpret_cast<const char *>(&entry), sizeof(entry));
+    }
+    torn << "torn";
+  }
+  {
+    HandHistory history;
+    ASSERT_TRUE(history.open(HISTORY_FILE));
+    ASSERT_EQUAL(history.size(), hands + 2);
+  }
+
+  // The next writer trims it and carries on numbering games
+  HandHistoryWriter writer;
+  ASSERT_TRUE(writer.open(HISTORY_FILE));
+  ASSERT_EQUAL(writer.next_game_id(), 2u);
+  ASSERT_TRUE(writer.append(record_games(1, 5)[0]));
+  HandHistory history;
+  ASSERT_TRUE(history.open(HISTORY_FILE));
+  ASSERT_EQUAL(history[history.size() - 1].game_id, 2u);
+  ASSERT_EQUAL(history[hands].hand_number, 0);
+  remove_history();
+}
+
+TEST(test_history_rejects_other_files) {
+  remove_history();
+  {
+    ofstream other(HISTORY_FILE);
+    other << "Nine of Spades\nTen of Spades\nJack of Spades\n";
+  }
+  HandHistory history;
+  ASSERT_FALSE(history.open("no_such_history.hh"));
+  ASSERT_FALSE(history.open(HISTORY_FILE));
+  HandHistoryWriter writer;
+  ASSERT_FALSE(writer.open(HISTORY_FILE));
+  remove_history();
+}
+
+TEST_MAIN()
@@ -0,0 +1,118 @@
+#include "Hand.hpp"
+#include "unit_test_framework.hpp"
+
+#include <vector>
+
+using namespace std;
+
+// Every euchre card, Nine of Spades through Ace of Diamonds
+static vector<Card> euchre_cards() {
+    vector<Card> cards;
+    for (int i = 0; i < Hand::NUM_CARDS; ++i) {
+        cards.push_back(Card::from_index(Hand::FIRST_INDEX + i));
+    }
+    return cards;
+}
+
+TEST(test_hand_add_remove) {
+    Hand hand;
+    ASSERT_TRUE(hand.empty());
+    hand.add(Card(NINE, SPADES));
+    hand.add(Card(ACE, DIAMONDS));
+    ASSERT_EQUAL(hand.size(), 2);
+    ASSERT_TRUE(hand.contains(Card(ACE, DIAMONDS)));
+    ASSERT_FALSE(hand.contains(Card(ACE, HEARTS)));
+    ASSERT_EQUAL(hand.first(), Card(NINE, SPADES));
+    ASSERT_EQUAL(hand.last(), Card(ACE, DIAMONDS));
+    hand.remove(Card(NINE, SPADES));
+    ASSERT_EQUAL(hand.size(), 1);
+    ASSERT_FALSE(hand.contains(Card(NINE, SPADES)));
+}
+
+TEST(test_hand_holds_no_card_below_nine) {
+    ASSERT_TRUE(Hand::of(Card(TWO, SPADES)).empty());
+    ASSERT_TRUE(Hand::of(Card(EIGHT, DIAMONDS)).empty());
+    ASSERT_EQUAL(Hand::of(Card(NINE, SPADES)).get_bits(), 1u);
+    ASSERT_FALSE(Hand::full().contains(Card(EIGHT, DIAMONDS)));
+    ASSERT_TRUE(Hand::full().contains(Card(ACE, DIAMONDS)));
+}
+
+TEST(test_hand_suit_cards_move_left_bower) {
+    Hand hand = Hand::of(Card(JACK, CLUBS)) | Hand::of(Card(NINE, CLUBS))
+                | Hand::of(Card(TEN, SPADES));
+    ASSERT_EQUAL(hand.trump_cards(SPADES).size(), 2);
+    ASSERT_EQUAL(hand.in_suit(CLUBS, SPADES), Hand::of(Card(NINE, CLUBS)));
+    ASSERT_EQUAL(hand.in_suit(CLUBS, HEARTS).size(), 2);
+    ASSERT_EQUAL(hand.face_or_ace(), Hand::of(Card(JACK, CLUBS)));
+}
+
+TEST(test_hand_suit_cards_match_get_suit) {
+    vector<Card> cards = euchre_cards();
+    for (int t = SPADES; t <= DIAMONDS; ++t) {
+        Suit trump = static_cast<Suit>(t);
+        for (int s = SPADES; s <= DIAMONDS; ++s) {
+            Hand suit = Hand::suit_cards(static_cast<Suit>(s), trump);
+            for (const Card &c : cards) {
+                ASSERT_EQUAL(suit.contains(c), c.get_suit(trump) == s);
+            }
+        }
+    }
+}
+
+// Compare highest/lowest with a linear Card_less scan over sampled hands
+TEST(test_hand_highest_lowest_match_card_less) {
+    vector<Card> cards = euchre_cards();
+    for (uint32_t bits = 1; bits < (1u << Hand::NUM_CARDS); bits += 4099) {
+        Hand hand(bits);
+        for (int t = SPADES; t <= DIAMONDS; ++t) {
+            Suit trump = static_cast<Suit>(t);
+            Card high = hand.first();
+            Card low = hand.first();
+            for (const Card &c : cards) {
+                if (!hand.contains(c)) continue;
+                if (Card_less(high, c, trump)) high = c;
+                if (Card_less(c, low, trump)) low = c;
+            }
+            ASSERT_EQUAL(hand.highest(trump), high);
+            ASSERT_EQUAL(hand.lowest(trump), low);
+        }
+    }
+}
+
+TEST(test_legal_moves_follow_suit) {
+    Hand hand = Hand::of(Card(NINE, HEARTS)) | Hand::of(Card(JACK, DIAMONDS))
+                | Hand::of(Card(ACE, SPADES));
+    // Hearts is trump, so the Jack of Diamonds is trump too
+    ASSERT_EQUAL(legal_moves(hand, Card(KING, HEARTS), HEARTS),
+                 Hand::of(Card(NINE, HEARTS)) | Hand::of(Card(JACK, DIAMONDS)));
+    // A led left bower asks for trump
+    ASSERT_EQUAL(legal_moves(hand, Card(JACK, CLUBS), SPADES),
+                 Hand::of(Card(ACE, SPADES)));
+    // Diamonds led but the only diamond is the left bower
+    ASSERT_EQUAL(legal_moves(hand, Card(KING, DIAMONDS), HEARTS), hand);
+}
+
+TEST(test_legal_moves_match_get_suit) {
+    vector<Card> cards = euchre_cards();
+    for (uint32_t bits = 1; bits < (1u << Hand::NUM_CARDS); bits += 65537) {
+        Hand hand(bits);
+        for (int t = SPADES; t <= DIAMONDS; ++t) {
+            Suit trump = static_cast<Suit>(t);
+            for (const Card &led : cards) {
+                Suit led_suit = led.get_suit(trump);
+                bool can_follow = false;
+                for (const Card &c : cards) {
+                    can_follow |= hand.contains(c) && c.get_suit(trump) == led_suit;
+                }
+                Hand legal = legal_moves(hand, led, trump);
+                for (const Card &c : cards) {
+                    bool ok = hand.contains(c)
+                              && (!can_follow || c.get_suit(trump) == led_suit);
+                    ASSERT_EQUAL(legal.contains(c), ok);
+                }
+            }
+        }
+    }
+}
+
+TEST_MAIN()
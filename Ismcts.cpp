@@ -0,0 +1,262 @@
+// Ismcts.cpp
+#include "Ismcts.hpp"
+#include "Player.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+
+// Weight of the UCB1 exploration term, for rewards between 0 and 1
+static const double EXPLORATION = 0.7;
+
+bool IsmctsOptions::parse(const string &spec) {
+  if (spec.empty()) {
+    return true;
+  }
+  const size_t ms = spec.find_first_not_of("0123456789");
+  const int value = atoi(spec.c_str());
+  if (value < 1 || (ms != string::npos && spec.compare(ms, 3, "ms") != 0)) {
+    return false;
+  }
+  if (ms != string::npos) {
+    time_ms = value;
+    iterations = 0;
+  } else {
+    time_ms = 0;
+    iterations = value;
+  }
+  return true;
+}
+
+// Points to team 0 less points to team 1 once the hand is over
+static int team0_points(int maker, const array<int, 2> &tricks) {
+  const int makers = maker % 2;
+  const int points = tricks[makers] == 5 ? 2 : tricks[makers] >= 3 ? 1 : -2;
+  return makers == 0 ? points : -points;
+}
+
+void IsmctsSearch::reset(int seat) {
+  nodes.clear();
+  nodes.push_back(Node{NONE, seat});
+}
+
+int IsmctsSearch::child(int parent, int move) const {
+  int c = nodes[parent].first_child;
+  while (c != NONE && nodes[c].move != move) {
+    c = nodes[c].next_sibling;
+  }
+  return c;
+}
+
+int IsmctsSearch::add_child(int parent, int move, int mover) {
+  Node node{move, mover};
+  node.next_sibling = nodes[parent].first_child;
+  node.available = 1;
+  nodes.push_back(node);
+  nodes[parent].first_child = nodes.size() - 1;
+  return nodes.size() - 1;
+}
+
+// Expands a random move not tried from parent yet, or else takes the
+// child with the best UCB1 score among the moves open this iteration
+int IsmctsSearch::select(int parent, const Moves &moves, int mover, Rng &rng) {
+  array<int, 5> untried;
+  int num_untried = 0;
+  int best = NONE;
+  double best_score = 0;
+  for (int i = 0; i < moves.size; ++i) {
+    const int c = child(parent, moves.move[i]);
+    if (c == NONE) {
+      untried[num_untried++] = moves.move[i];
+      continue;
+    }
+    Node &node = nodes[c];
+    ++node.available;
+    const double score = node.reward / node.visits
+        + EXPLORATION * sqrt(log(node.available) / node.visits);
+    if (best == NONE || score > best_score) {
+      best = c;
+      best_score = score;
+    }
+  }
+  if (num_untried > 0) {
+    return add_child(parent, untried[rng.below(num_untried)], mover);
+  }
+  return best;
+}
+
+static void play(Position &pos, array<int, 2> &tricks, const Card &card) {
+  const int winner = pos.play(card);
+  if (winner >= 0) {
+    ++tricks[winner % 2];
+  }
+}
+
+static bool hand_over(const Position &pos) {
+  return pos.hands[pos.to_play()].empty();
+}
+
+// Plays the rest of the hand with the Simple strategy for every seat
+static void play_out(Position &pos, array<int, 2> &tricks) {
+  while (!hand_over(pos)) {
+    const Hand hand = pos.hands[pos.to_play()];
+    play(pos, tricks,
+         pos.played == 0 ? simple_lead(hand, pos.trump)
+                         : simple_play(hand, pos.trick[0], pos.trump));
+  }
+}
+
+// Follows the tree through the rest of the hand until it adds a node,
+// then plays the hand out
+void IsmctsSearch::descend(Deal &deal, Rng &rng) {
+  Position &pos = deal.pos;
+  bool expanded = false;
+  while (!expanded && !hand_over(pos)) {
+    Moves moves;
+    for (Hand legal = pos.legal(); !legal.empty();
+         legal.remove(legal.first())) {
+      moves.move[moves.size++] = legal.first().get_index();
+    }
+    const size_t before = nodes.size();
+    const int node = select(path.back(), moves, pos.to_play(), rng);
+    expanded = nodes.size() > before;
+    path.push_back(node);
+    play(pos, deal.tricks, Card::from_index(nodes[node].move));
+  }
+  play_out(pos, deal.tricks);
+}
+
+void IsmctsSearch::backpropagate(const Deal &deal) {
+  const int points = team0_points(deal.maker, deal.tricks);
+  for (int n : path) {
+    Node &node = nodes[n];
+    const int team_points = node.mover % 2 == 0 ? points : -points;
+    ++node.visits;
+    node.reward += (team_points + 2) / 4.0;
+  }
+}
+
+int IsmctsSearch::most_visited() const {
+  int best = nodes[0].first_child;
+  for (int c = best; c != NONE; c = nodes[c].next_sibling) {
+    const Node &node = nodes[c];
+    const Node &top = nodes[best];
+    if (node.visits > top.visits || (node.visits == top.visits
+                                     && node.reward > top.reward)) {
+      best = c;
+    }
+  }
+  return best;
+}
+
+// Runs iteration until the deadline or iteration limit, but at least
+// min_iterations times so every move at the root gets tried
+template <typename Iteration>
+void IsmctsSearch::search(int min_iterations, Iteration iteration) {
+  using Clock = chrono::steady_clock;
+  const Clock::time_point deadline =
+      Clock::now() + chrono::milliseconds(opts.time_ms);
+  for (iterations = 0;; ++iterations) {
+    if (iterations >= min_iterations
+        && ((opts.iterations > 0 && iterations >= opts.iterations)
+            || (opts.time_ms > 0 && Clock::now() >= deadline))) {
+      return;
+    }
+    path.assign(1, 0);
+    iteration();
+  }
+}
+
+// The deal once bidding is over, with a Simple dealer's pickup
+static Position start_hand(array<Hand, 4> hands, const PlayerView &view,
+                           Suit trump, bool pickup) {
+  const int dealer = view.get_dealer();
+  if (pickup) {
+    hands[dealer].add(view.get_upcard());
+    hands[dealer].remove(simple_discard(hands[dealer], view.get_upcard()));
+  }
+  Position pos;
+  pos.hands = hands;
+  pos.trump = trump;
+  pos.leader = (dealer + 1) % 4;
+  return pos;
+}
+
+// Bids for every seat after the searching seat passes in round, all with
+// the Simple strategy, and returns the maker
+static int bid_out(array<Hand, 4> hands, const PlayerView &view, int round,
+                   Position &pos) {
+  const int dealer = view.get_dealer();
+  const Card &upcard = view.get_upcard();
+  const int passed = (view.get_seat() - dealer + 3) % 4;
+  for (int r = round; r <= 2; ++r) {
+    for (int i = r == round ? passed + 1 : 0; i < 4; ++i) {
+      const int seat = (dealer + 1 + i) % 4;
+      Suit trump;
+      if (simple_make_trump(hands[seat], upcard, seat == dealer, r, trump)) {
+        pos = start_hand(hands, view, trump, r == 1);
+        return seat;
+      }
+    }
+  }
+  pos = start_hand(hands, view, upcard.get_suit(), false);
+  return dealer;
+}
+
+bool IsmctsSearch::choose_bid(const PlayerView &view, Hand own, int round,
+                              Suit &order_up_suit, uint64_t seed) {
+  const int seat = view.get_seat();
+  const Suit up_suit = view.get_upcard().get_suit();
+  Moves bids;
+  for (int s = SPADES; s <= DIAMONDS; ++s) {
+    if ((s == up_suit) == (round == 1)) {
+      bids.move[bids.size++] = CALL + s;
+    }
+  }
+  if (round == 1 || seat != view.get_dealer()) {
+    bids.move[bids.size++] = PASS;
+  }
+
+  reset(seat);
+  Rng rng(seed);
+  search(bids.size, [&]() {
+    const array<Hand, 4> hands = view.sample_deal(own, rng);
+    const int node = select(0, bids, seat, rng);
+    path.push_back(node);
+    Deal deal;
+    deal.tricks = {{0, 0}};
+    // Trump after a pass depends on the hidden cards, so that subtree is
+    // left as a leaf and only played out
+    if (nodes[node].move == PASS) {
+      deal.maker = bid_out(hands, view, round, deal.pos);
+      play_out(deal.pos, deal.tricks);
+    } else {
+      const Suit trump = static_cast<Suit>(nodes[node].move - CALL);
+      deal.maker = seat;
+      deal.pos = start_hand(hands, view, trump, round == 1);
+      descend(deal, rng);
+    }
+    backpropagate(deal);
+  });
+
+  const int best = nodes[most_visited()].move;
+  if (best == PASS) {
+    return false;
+  }
+  order_up_suit = static_cast<Suit>(best - CALL);
+  return true;
+}
+
+Card IsmctsSearch::choose_card(const PlayerView &view, Hand own,
+                               uint64_t seed) {
+  reset(view.get_seat());
+  Rng rng(seed);
+  const int num_moves = view.sample(own, rng).legal().size();
+  search(num_moves, [&]() {
+    Deal deal{view.sample(own, rng), view.get_maker(), view.get_tricks()};
+    descend(deal, rng);
+    backpropagate(deal);
+  });
+  return Card::from_index(nodes[most_visited()].move);
+}
@@ -0,0 +1,98 @@
+#ifndef ISMCTS_HPP
+#define ISMCTS_HPP
+/* Ismcts.hpp
+ *
+ * Information-set Monte Carlo tree search: one tree over the moves a seat
+ * can see, grown by playing random determinizations of the hidden cards
+ */
+
+#include "Card.hpp"
+#include "Hand.hpp"
+#include "PlayerView.hpp"
+#include "Random.hpp"
+#include "Solver.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct IsmctsOptions {
+  int time_ms = 20;    // wall-clock budget per decision, or 0 for none
+  int iterations = 0;  // iterations per decision, or 0 for no limit
+
+  //EFFECTS Parses "MILLISms" or "ITERATIONS", or "" for the defaults.
+  //  Returns false if spec is malformed.
+  bool parse(const std::string &spec);
+};
+
+class IsmctsSearch {
+public:
+  explicit IsmctsSearch(const IsmctsOptions &opts_in) : opts(opts_in) {}
+
+  //REQUIRES own holds the seat's five cards and it is the seat's turn to
+  //  bid in round (1 or 2)
+  //MODIFIES order_up_suit
+  //EFFECTS Returns true and sets order_up_suit if ordering up scores best
+  //  for the seat's team, searching until the deadline or iteration limit.
+  //  Other seats are played by the Simple strategy while bidding, and the
+  //  dealer discards like a Simple player.
+  bool choose_bid(const PlayerView &view, Hand own, int round,
+                  Suit &order_up_suit, uint64_t seed);
+
+  //REQUIRES own holds the cards of view's seat and it is that seat's turn
+  //EFFECTS Returns the legal card whose subtree was searched most, which
+  //  is the best move found when the deadline or iteration limit is hit
+  Card choose_card(const PlayerView &view, Hand own, uint64_t seed);
+
+  //EFFECTS Returns the iterations run by the last decision
+  int get_iterations() const { return iterations; }
+
+private:
+  // A move from the point of view of the seat that made it: a card
+  // index, or one of the bids below
+  static const int CALL = Card::NUM_INDICES;  // CALL + suit orders up suit
+  static const int PASS = CALL + 4;
+  static const int NONE = -1;
+
+  // The moves open at a node in one determinization: at most five cards,
+  // or a pass and three suits
+  struct Moves {
+    std::array<int, 5> move;
+    int size = 0;
+  };
+
+  struct Node {
+    int move;
+    int mover;         // seat that made move
+    int first_child = NONE;
+    int next_sibling = NONE;
+    int visits = 0;
+    int available = 0; // iterations in which move could have been made
+    double reward = 0; // total reward to the mover's team
+  };
+
+  // A determinized hand being played out
+  struct Deal {
+    Position pos;
+    int maker;
+    std::array<int, 2> tricks;
+  };
+
+  IsmctsOptions opts;
+  std::vector<Node> nodes;
+  std::vector<int> path;
+  int iterations = 0;
+
+  void reset(int seat);
+  int child(int parent, int move) const;
+  int add_child(int parent, int move, int mover);
+  int select(int parent, const Moves &moves, int mover, Rng &rng);
+  void descend(Deal &deal, Rng &rng);
+  void backpropagate(const Deal &deal);
+  int most_visited() const;
+
+  template <typename Iteration>
+  void search(int min_iterations, Iteration iteration);
+};
+
+#endif // ISMCTS_HPP
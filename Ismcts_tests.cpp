@@ -0,0 +1,105 @@
+#include "Ismcts.hpp"
+#include "unit_test_framework.hpp"
+
+#include <chrono>
+
+using namespace std;
+
+// Seat 1's hand: both black bowers, the Ace and King of Spades and the
+// Ace of Hearts
+static Hand strong_spades() {
+  return Hand::of(Card(JACK, SPADES)) | Hand::of(Card(JACK, CLUBS))
+       | Hand::of(Card(ACE, SPADES)) | Hand::of(Card(KING, SPADES))
+       | Hand::of(Card(ACE, HEARTS));
+}
+
+// Seat 1's hand: nines and tens with no Spades or Clubs
+static Hand weak_red() {
+  return Hand::of(Card(NINE, HEARTS)) | Hand::of(Card(TEN, HEARTS))
+       | Hand::of(Card(NINE, DIAMONDS)) | Hand::of(Card(TEN, DIAMONDS))
+       | Hand::of(Card(QUEEN, DIAMONDS));
+}
+
+static IsmctsOptions iterations(int n) {
+  IsmctsOptions opts;
+  opts.time_ms = 0;
+  opts.iterations = n;
+  return opts;
+}
+
+TEST(test_ismcts_options_parse) {
+  IsmctsOptions opts;
+  ASSERT_TRUE(opts.parse(""));
+  ASSERT_EQUAL(opts.time_ms, 20);
+  ASSERT_TRUE(opts.parse("300"));
+  ASSERT_EQUAL(opts.iterations, 300);
+  ASSERT_EQUAL(opts.time_ms, 0);
+  ASSERT_TRUE(opts.parse("7ms"));
+  ASSERT_EQUAL(opts.time_ms, 7);
+  ASSERT_EQUAL(opts.iterations, 0);
+  ASSERT_FALSE(opts.parse("0"));
+  ASSERT_FALSE(opts.parse("7s"));
+  ASSERT_FALSE(opts.parse("7msx"));
+}
+
+TEST(test_ismcts_orders_up_strong_hand) {
+  PlayerView view;
+  view.deal(1, 0, Card(QUEEN, SPADES));
+  IsmctsSearch search(iterations(400));
+  Suit suit = HEARTS;
+  ASSERT_TRUE(search.choose_bid(view, strong_spades(), 1, suit, 1));
+  ASSERT_EQUAL(suit, SPADES);
+  ASSERT_EQUAL(search.get_iterations(), 400);
+}
+
+TEST(test_ismcts_passes_weak_hand) {
+  PlayerView view;
+  view.deal(1, 0, Card(QUEEN, SPADES));
+  IsmctsSearch search(iterations(400));
+  Suit suit = HEARTS;
+  ASSERT_FALSE(search.choose_bid(view, weak_red(), 1, suit, 1));
+  ASSERT_EQUAL(suit, HEARTS);
+}
+
+TEST(test_ismcts_dealer_must_call_in_round_two) {
+  PlayerView view;
+  view.deal(1, 1, Card(QUEEN, SPADES));
+  IsmctsSearch search(iterations(50));
+  Suit suit = SPADES;
+  ASSERT_TRUE(search.choose_bid(view, weak_red(), 2, suit, 1));
+  ASSERT_NOT_EQUAL(suit, SPADES);
+}
+
+TEST(test_ismcts_leads_legal_card) {
+  PlayerView view;
+  view.deal(1, 0, Card(QUEEN, SPADES));
+  view.trump_made({1, 1, SPADES});
+  view.play({1, Card(JACK, SPADES), true});
+  view.play({2, Card(NINE, SPADES), false});
+  view.play({3, Card(NINE, CLUBS), false});
+  view.play({0, Card(QUEEN, SPADES), false});
+
+  const Hand own = strong_spades().without(Hand::of(Card(JACK, SPADES)));
+  IsmctsSearch search(iterations(300));
+  const Card led = search.choose_card(view, own, 2);
+  ASSERT_TRUE(own.contains(led));
+}
+
+TEST(test_ismcts_meets_deadline) {
+  PlayerView view;
+  view.deal(1, 0, Card(QUEEN, SPADES));
+  IsmctsOptions opts;
+  ASSERT_TRUE(opts.parse("5ms"));
+  IsmctsSearch search(opts);
+
+  using Clock = chrono::steady_clock;
+  const Clock::time_point start = Clock::now();
+  Suit suit;
+  search.choose_bid(view, strong_spades(), 1, suit, 3);
+  const auto elapsed = chrono::duration_cast<chrono::milliseconds>(
+      Clock::now() - start).count();
+  ASSERT_TRUE(elapsed < 50);
+  ASSERT_TRUE(search.get_iterations() > 2);
+}
+
+TEST_MAIN()
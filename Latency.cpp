@@ -0,0 +1,193 @@
+// Latency.cpp
+#include "Latency.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+using namespace std;
+
+/////////////// LatencyHistogram ///////////////
+
+void LatencyHistogram::record(uint64_t ns) {
+  buckets[bucket_of(ns)].fetch_add(1, memory_order_relaxed);
+  total.fetch_add(1, memory_order_relaxed);
+  uint64_t seen = largest.load(memory_order_relaxed);
+  while (ns > seen
+         && !largest.compare_exchange_weak(seen, ns, memory_order_relaxed)) {
+  }
+}
+
+int LatencyHistogram::bucket_of(uint64_t ns) {
+  if (ns < 2 * SUB_BUCKETS) {
+    return static_cast<int>(ns);
+  }
+  // The top SUB_BITS + 1 bits of ns, and how far they were shifted down
+  const int shift = 63 - __builtin_clzll(ns) - SUB_BITS;
+  return shift * SUB_BUCKETS + static_cast<int>(ns >> shift);
+}
+
+uint64_t LatencyHistogram::bucket_max(int bucket) {
+  if (bucket < 2 * SUB_BUCKETS) {
+    return bucket;
+  }
+  const int shift = bucket / SUB_BUCKETS - 1;
+  const uint64_t top = bucket % SUB_BUCKETS + SUB_BUCKETS;
+  return ((top + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::percentile(double quantile) const {
+  const uint64_t n = count();
+  if (n == 0) {
+    return 0;
+  }
+  // The rank of the latency at quantile, counting from 1
+  const uint64_t rank = std::max<uint64_t>(1, ceil(quantile * n));
+  uint64_t seen = 0;
+  for (int b = 0; b < NUM_BUCKETS; ++b) {
+    seen += buckets[b].load(memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(bucket_max(b), max());
+    }
+  }
+  return max();
+}
+
+/////////////// DecisionLatencies ///////////////
+
+static const char *const DECISION_NAMES[NUM_DECISIONS] = {
+  "make_trump", "add_and_discard", "lead_card", "play_card"
+};
+
+LatencyHistogram & DecisionLatencies::histogram(const string &strategy,
+                                                Decision decision) {
+  lock_guard<mutex> guard(lock);
+  unique_ptr<Histograms> &found = strategies[strategy];
+  if (!found) {
+    found.reset(new Histograms());
+  }
+  return (*found)[decision];
+}
+
+void DecisionLatencies::print(ostream &os) const {
+  lock_guard<mutex> guard(lock);
+  os << left << setw(24) << "strategy" << setw(16) << "decision" << right
+     << setw(10) << "count" << setw(12) << "p50 ns" << setw(12) << "p99 ns"
+     << setw(12) << "p999 ns" << setw(12) << "max ns" << '\n';
+  for (const auto &strategy : strategies) {
+    for (int d = 0; d < NUM_DECISIONS; ++d) {
+      const LatencyHistogram &h = (*strategy.second)[d];
+      if (h.count() == 0) {
+        continue;
+      }
+      os << left << setw(24) << strategy.first << setw(16) << DECISION_NAMES[d]
+         << right << setw(10) << h.count() << setw(12) << h.percentile(0.5)
+         << setw(12) << h.percentile(0.99) << setw(12) << h.percentile(0.999)
+         << setw(12) << h.max() << '\n';
+    }
+  }
+  os << flush;
+}
+
+/////////////// Player_timed ///////////////
+
+// Forwards every call to the wrapped Player, timing the decisions
+class TimedPlayer : public Player {
+public:
+  TimedPlayer(Player *player_in, const string &strategy,
+              DecisionLatencies &latencies)
+    : player(player_in),
+      make_trump_ns(latencies.histogram(strategy, DECISION_MAKE_TRUMP)),
+      discard_ns(latencies.histogram(strategy, DECISION_ADD_AND_DISCARD)),
+      lead_ns(latencies.histogram(strategy, DECISION_LEAD_CARD)),
+      play_ns(latencies.histogram(strategy, DECISION_PLAY_CARD)) {}
+
+  const string & get_name() const override {
+    return player->get_name();
+  }
+
+  void add_card(const Card &c) override {
+    player->add_card(c);
+  }
+
+  bool make_trump(const Card &upcard, bool is_dealer, int round,
+                  Suit &order_up_suit) const override {
+    const Clock::time_point start = Clock::now();
+    const bool order_up =
+        player->make_trump(upcard, is_dealer, round, order_up_suit);
+    make_trump_ns.record(since(start));
+    return order_up;
+  }
+
+  Card add_and_discard(const Card &upcard) override {
+    const Clock::time_point start = Clock::now();
+    const Card discard = player->add_and_discard(upcard);
+    discard_ns.record(since(start));
+    return discard;
+  }
+
+  Card lead_card(Suit trump) override {
+    const Clock::time_point start = Clock::now();
+    const Card led = player->lead_card(trump);
+    lead_ns.record(since(start));
+    return led;
+  }
+
+  Card play_card(const Card &led_card, Suit trump) override {
+    const Clock::time_point start = Clock::now();
+    const Card played = player->play_card(led_card, trump);
+    play_ns.record(since(start));
+    return played;
+  }
+
+  void observe_deal(int seat, int dealer, const Card &upcard) override {
+    player->observe_deal(seat, dealer, upcard);
+  }
+
+  void observe_trump(const TrumpEvent &e) override {
+    player->observe_trump(e);
+  }
+
+  void observe_play(const PlayEvent &e) override {
+    player->observe_play(e);
+  }
+
+private:
+  using Clock = chrono::steady_clock;
+
+  unique_ptr<Player> player;
+  LatencyHistogram &make_trump_ns;
+  LatencyHistogram &discard_ns;
+  LatencyHistogram &lead_ns;
+  LatencyHistogram &play_ns;
+
+  static uint64_t since(Clock::time_point start) {
+    return chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start)
+        .count();
+  }
+};
+
+Player * Player_timed(Player *player, const string &strategy,
+                      DecisionLatencies &latencies) {
+  return new TimedPlayer(player, strategy, latencies);
+}
+
+/////////////// LatencyReporter ///////////////
+
+LatencyReporter::LatencyReporter(const DecisionLatencies &latencies,
+                                 ostream &os, chrono::milliseconds period) {
+  worker = thread([this, &latencies, &os, period] {
+    unique_lock<mutex> guard(lock);
+    while (!wake.wait_for(guard, period, [this] { return stopping; })) {
+      latencies.print(os);
+    }
+  });
+}
+
+LatencyReporter::~LatencyReporter() {
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_one();
+  worker.join();
+}
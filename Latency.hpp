@@ -0,0 +1,104 @@
+#ifndef LATENCY_HPP
+#define LATENCY_HPP
+/* Latency.hpp
+ *
+ * Latency histograms for Player decisions, kept per strategy and kind of
+ * decision, and a Player wrapper that records them
+ */
+
+#include "Player.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Counts of latencies in log-spaced buckets, as in HdrHistogram: exact
+// below 2 * SUB_BUCKETS ns, then SUB_BUCKETS buckets for every power of
+// two, so a reported value is at most 1 / SUB_BUCKETS above the true one.
+// Any number of threads may record and read at once.
+class LatencyHistogram {
+public:
+  static const int SUB_BITS = 5;
+  static const int SUB_BUCKETS = 1 << SUB_BITS;
+  static const int NUM_BUCKETS = (65 - SUB_BITS) * SUB_BUCKETS;
+
+  //EFFECTS Adds one latency of ns nanoseconds
+  void record(uint64_t ns);
+
+  //EFFECTS Returns the number of latencies recorded
+  uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+  //EFFECTS Returns the largest latency recorded, exactly, or 0 if none
+  uint64_t max() const { return largest.load(std::memory_order_relaxed); }
+
+  //REQUIRES 0 <= quantile <= 1
+  //EFFECTS Returns the upper bound of the bucket holding the latency at
+  //  quantile, never more than max(), or 0 if none are recorded
+  uint64_t percentile(double quantile) const;
+
+  //EFFECTS Returns the bucket that holds ns
+  static int bucket_of(uint64_t ns);
+
+  //EFFECTS Returns the largest latency that falls in bucket
+  static uint64_t bucket_max(int bucket);
+
+private:
+  std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets = {};
+  std::atomic<uint64_t> total{0};
+  std::atomic<uint64_t> largest{0};
+};
+
+// A histogram for every kind of decision of every strategy
+class DecisionLatencies {
+public:
+  //EFFECTS Returns the histogram for decision by players of strategy,
+  //  adding it if there is none.  The histogram lives as long as this.
+  LatencyHistogram & histogram(const std::string &strategy,
+                               Decision decision);
+
+  //EFFECTS Prints count, p50, p99, p999 and max for every histogram with
+  //  anything recorded, in nanoseconds
+  void print(std::ostream &os) const;
+
+private:
+  using Histograms = std::array<LatencyHistogram, NUM_DECISIONS>;
+  mutable std::mutex lock;
+  std::map<std::string, std::unique_ptr<Histograms>> strategies;
+};
+
+//REQUIRES latencies outlives the returned Player
+//EFFECTS Returns a Player that makes every decision by asking player,
+//  recording how long each took in latencies under strategy.  The
+//  returned Player owns player.
+Player * Player_timed(Player *player, const std::string &strategy,
+                      DecisionLatencies &latencies);
+
+// Prints latencies to os every period on a thread of its own, until it is
+// destroyed
+class LatencyReporter {
+public:
+  //REQUIRES latencies and os outlive the reporter
+  LatencyReporter(const DecisionLatencies &latencies, std::ostream &os,
+                  std::chrono::milliseconds period);
+
+  LatencyReporter(const LatencyReporter &) = delete;
+  LatencyReporter & operator=(const LatencyReporter &) = delete;
+
+  //EFFECTS Stops the reporting thread
+  ~LatencyReporter();
+
+private:
+  std::mutex lock;
+  std::condition_variable wake;
+  bool stopping = false;
+  std::thread worker;
+};
+
+#endif // LATENCY_HPP
@@ -0,0 +1,125 @@
+#include "Latency.hpp"
+#include "Pack.hpp"
+#include "Random.hpp"
+#include "unit_test_framework.hpp"
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+TEST(test_histogram_buckets_are_contiguous_and_tight) {
+  ASSERT_EQUAL(LatencyHistogram::bucket_of(0), 0);
+  ASSERT_EQUAL(LatencyHistogram::bucket_of(63), 63);
+  ASSERT_EQUAL(LatencyHistogram::bucket_of(64), 64);
+  ASSERT_EQUAL(LatencyHistogram::bucket_of(UINT64_MAX),
+               LatencyHistogram::NUM_BUCKETS - 1);
+  for (int b = 1; b < LatencyHistogram::NUM_BUCKETS; ++b) {
+    const uint64_t low = LatencyHistogram::bucket_max(b - 1) + 1;
+    const uint64_t high = LatencyHistogram::bucket_max(b);
+    ASSERT_EQUAL(LatencyHistogram::bucket_of(low), b);
+    ASSERT_EQUAL(LatencyHistogram::bucket_of(high), b);
+    // Every value in a bucket is within 1 / SUB_BUCKETS of its top
+    ASSERT_TRUE(high - low <= low / LatencyHistogram::SUB_BUCKETS);
+  }
+}
+
+TEST(test_histogram_percentiles) {
+  LatencyHistogram h;
+  ASSERT_EQUAL(h.percentile(0.5), 0u);
+  for (uint64_t ns = 1; ns <= 10000; ++ns) {
+    h.record(ns * 1000);
+  }
+  ASSERT_EQUAL(h.count(), 10000u);
+  ASSERT_EQUAL(h.max(), 10000000u);
+  const uint64_t p50 = h.percentile(0.5);
+  ASSERT_TRUE(p50 >= 5000000 && p50 <= 5000000 + 5000000 / 32);
+  const uint64_t p99 = h.percentile(0.99);
+  ASSERT_TRUE(p99 >= 9900000 && p99 <= 9900000 + 9900000 / 32);
+  ASSERT_TRUE(h.percentile(0.999) <= h.max());
+  ASSERT_EQUAL(h.percentile(1), h.max());
+}
+
+TEST(test_histogram_one_spike_shows_in_tail) {
+  LatencyHistogram h;
+  for (int i = 0; i < 999; ++i) {
+    h.record(100);
+  }
+  h.record(5000000);
+  ASSERT_TRUE(h.percentile(0.99) <= 103);
+  ASSERT_TRUE(h.percentile(0.999) <= 103);
+  ASSERT_EQUAL(h.percentile(0.9995), 5000000u);
+  ASSERT_EQUAL(h.max(), 5000000u);
+}
+
+TEST(test_histogram_records_from_many_threads) {
+  LatencyHistogram h;
+  vector<thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&h, t] {
+      for (int i = 0; i < 10000; ++i) {
+        h.record(i * (t + 1));
+      }
+    });
+  }
+  for (thread &t : threads) t.join();
+  ASSERT_EQUAL(h.count(), 40000u);
+  ASSERT_EQUAL(h.max(), 39996u);
+}
+
+TEST(test_timed_player_forwards_and_records) {
+  DecisionLatencies latencies;
+  Player *timed = Player_timed(Player_factory("Ann", "Simple"), "Simple",
+                               latencies);
+  Player *plain = Player_factory("Ann", "Simple");
+  ASSERT_EQUAL(timed->get_name(), "Ann");
+
+  Rng rng(6);
+  Pack pack;
+  pack.shuffle(rng);
+  for (int i = 0; i < Player::MAX_HAND_SIZE; ++i) {
+    const Card c = pack.deal_one();
+    timed->add_card(c);
+    plain->add_card(c);
+  }
+  const Card upcard = pack.deal_one();
+  Suit timed_suit = SPADES;
+  Suit plain_suit = SPADES;
+  ASSERT_EQUAL(timed->make_trump(upcard, true, 1, timed_suit),
+               plain->make_trump(upcard, true, 1, plain_suit));
+  ASSERT_EQUAL(timed_suit, plain_suit);
+  timed->add_and_discard(upcard);
+  plain->add_and_discard(upcard);
+  ASSERT_EQUAL(timed->lead_card(HEARTS), plain->lead_card(HEARTS));
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQUAL(timed->play_card(upcard, HEARTS),
+                 plain->play_card(upcard, HEARTS));
+  }
+  delete timed;
+  delete plain;
+
+  ASSERT_EQUAL(latencies.histogram("Simple", DECISION_MAKE_TRUMP).count(), 1u);
+  ASSERT_EQUAL(
+      latencies.histogram("Simple", DECISION_ADD_AND_DISCARD).count(), 1u);
+  ASSERT_EQUAL(latencies.histogram("Simple", DECISION_LEAD_CARD).count(), 1u);
+  ASSERT_EQUAL(latencies.histogram("Simple", DECISION_PLAY_CARD).count(), 4u);
+
+  ostringstream out;
+  latencies.print(out);
+  ASSERT_TRUE(out.str().find("play_card") != string::npos);
+  ASSERT_TRUE(out.str().find("p999 ns") != string::npos);
+}
+
+TEST(test_reporter_prints_periodically) {
+  DecisionLatencies latencies;
+  latencies.histogram("Simple", DECISION_LEAD_CARD).record(100);
+  ostringstream out;
+  {
+    LatencyReporter reporter(latencies, out, chrono::milliseconds(5));
+    this_thread::sleep_for(chrono::milliseconds(40));
+  }
+  ASSERT_TRUE(out.str().find("lead_card") != string::npos);
+}
+
+TEST_MAIN()
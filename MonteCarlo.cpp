@@ -0,0 +1,109 @@
+// MonteCarlo.cpp
+#include "MonteCarlo.hpp"
+#include "Player.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+// Sample cap when only a time budget is given
+static const int TIMED_SAMPLE_CAP = 4096;
+
+// Size of the table the solvers share
+static const int TABLE_LOG2_BUCKETS = 14;
+
+bool MonteCarloOptions::parse(const string &spec) {
+  if (spec.empty()) {
+    return true;
+  }
+  const size_t colon = spec.find(':');
+  const string budget = spec.substr(0, colon);
+  const size_t ms = budget.find("ms");
+  const int value = atoi(budget.c_str());
+  if (value < 1 || (ms != string::npos && ms + 2 != budget.size())) {
+    return false;
+  }
+  if (ms != string::npos) {
+    time_ms = value;
+    samples = TIMED_SAMPLE_CAP;
+  } else {
+    samples = value;
+  }
+  if (colon != string::npos) {
+    threads = atoi(spec.c_str() + colon + 1);
+    const size_t file = spec.find(':', colon + 1);
+    if (file != string::npos) {
+      endgame_filename = spec.substr(file + 1);
+      if (endgame_filename.empty()) {
+        return false;
+      }
+    }
+  }
+  return threads >= 1;
+}
+
+MonteCarloSearch::MonteCarloSearch(const MonteCarloOptions &opts_in)
+  : opts(opts_in), table(TABLE_LOG2_BUCKETS), pool(opts_in.threads) {
+  for (int i = 0; i < opts.threads; ++i) {
+    solvers.emplace_back(&table, opts.endgames);
+  }
+}
+
+Card MonteCarloSearch::choose_card(const PlayerView &view, Hand own,
+                                   uint64_t seed) {
+  using Clock = chrono::steady_clock;
+  const Clock::time_point deadline =
+      Clock::now() + chrono::milliseconds(opts.time_ms);
+  const Suit trump = view.get_trump();
+
+  array<Card, Player::MAX_HAND_SIZE> moves;
+  int num_moves = 0;
+  for (Hand rest = view.legal(own); !rest.empty();
+       rest.remove(rest.first())) {
+    moves[num_moves++] = rest.first();
+  }
+  if (num_moves == 1) {
+    return moves[0];
+  }
+  sort(moves.begin(), moves.begin() + num_moves,
+       [trump](const Card &a, const Card &b) { return Card_less(a, b, trump); });
+
+  // Positions recur across samples, so the solvers share one table.  Its
+  // entries are keyed by whole positions, trump included, and would stay
+  // exact, but last decision's rarely recur and only crowd out this one's.
+  table.clear();
+  using Totals = array<long, Player::MAX_HAND_SIZE>;
+  vector<Totals> totals(opts.threads, Totals());
+  const int team = view.get_seat() % 2;
+  const int tricks_left = own.size();
+
+  pool.run(opts.samples, [&](int worker, int sample) {
+    if (opts.time_ms > 0 && sample > 0 && Clock::now() >= deadline) {
+      return;
+    }
+    Rng rng(seed, sample);
+    const Position pos = view.sample(own, rng);
+    for (int i = 0; i < num_moves; ++i) {
+      Position child = pos;
+      const int winner = child.play(moves[i]);
+      const int team0 = (winner >= 0 && winner % 2 == 0)
+                        + solvers[worker].team0_tricks(child);
+      totals[worker][i] += team == 0 ? team0 : tricks_left - team0;
+    }
+  });
+
+  int best = 0;
+  Totals sum = Totals();
+  for (int i = 0; i < num_moves; ++i) {
+    for (const Totals &t : totals) {
+      sum[i] += t[i];
+    }
+    if (sum[i] > sum[best]) {
+      best = i;
+    }
+  }
+  return moves[best];
+}
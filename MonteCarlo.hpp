@@ -0,0 +1,56 @@
+#ifndef MONTE_CARLO_HPP
+#define MONTE_CARLO_HPP
+/* MonteCarlo.hpp
+ *
+ * Perfect-information Monte Carlo card play: sample the unseen cards,
+ * solve each sample double dummy, and play the card with the best average
+ */
+
+#include "Card.hpp"
+#include "Hand.hpp"
+#include "PlayerView.hpp"
+#include "Solver.hpp"
+#include "WorkStealing.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class EndgameTable;
+
+struct MonteCarloOptions {
+  int samples = 50;  // deals to sample per decision, or a cap with time_ms
+  int time_ms = 0;   // if positive, sample until this much time has passed
+  int threads = 1;   // threads solving samples in parallel
+  std::string endgame_filename; // endgame table to load, if any
+  const EndgameTable *endgames = nullptr; // if set, looks up the last tricks
+
+  //EFFECTS Parses "SAMPLES", "MILLISms", either followed by ":THREADS" and
+  //  then perhaps ":ENDGAME_FILENAME", or "" for the defaults.  Returns
+  //  false if spec is malformed.
+  bool parse(const std::string &spec);
+};
+
+// The solvers, their shared table and the threads that run them, kept from
+// one decision to the next
+class MonteCarloSearch {
+public:
+  explicit MonteCarloSearch(const MonteCarloOptions &opts_in);
+
+  MonteCarloSearch(const MonteCarloSearch &) = delete;
+  MonteCarloSearch & operator=(const MonteCarloSearch &) = delete;
+
+  //REQUIRES own holds the cards of view's seat and it is that seat's turn
+  //EFFECTS Returns the legal card with the most tricks for the seat's team,
+  //  averaged over sampled deals solved double dummy.  Ties go to the lowest
+  //  card by Card_less.  Sample i of a decision is drawn from Rng stream i
+  //  of seed, so a decision is reproducible for a fixed sample count.
+  Card choose_card(const PlayerView &view, Hand own, uint64_t seed);
+
+private:
+  MonteCarloOptions opts;
+  TranspositionTable table;               // shared by the solvers
+  std::vector<DoubleDummySolver> solvers; // one per worker
+  WorkStealingPool pool;
+};
+
+#endif // MONTE_CARLO_HPP
@@ -40,19 +40,29 @@ bool Pack::empty() const {
     return next >= PACK_SIZE;
 }
 
-// Shuffle using in-shuffle 7 times
+// Seven in-shuffles, composed at compile time
+static constexpr Pack::Permutation SEVEN_IN_SHUFFLES
+    = Pack::repeat(Pack::in_shuffle(), 7);
+
+// Shuffle using in-shuffle 7 times, applied as one permutation
 void Pack::shuffle() {
-    for (int shuffle_count = 0; shuffle_count < 7; ++shuffle_count) {
-        array<Card, PACK_SIZE> shuffled;
-        int mid = PACK_SIZE / 2;  // 12
-        int i = 0;
-        for (int k = 0; k < mid; ++k) {
-            shuffled[i++] = cards[mid + k]; // bottom half first
-            shuffled[i++] = cards[k];       // then top half
-        }
-        cards = shuffled;
+    permute(SEVEN_IN_SHUFFLES);
+}
+
+// Gather every card from its old position
+void Pack::permute(const Permutation &perm) {
+    array<Card, PACK_SIZE> permuted;
+    for (int i = 0; i < PACK_SIZE; ++i) {
+        permuted[i] = cards[perm[i]];
     }
+    cards = permuted;
     reset();
 }
 
-
+// Fisher-Yates shuffle from the back of the pack
+void Pack::shuffle(Rng &rng) {
+    for (int i = PACK_SIZE - 1; i > 0; --i) {
+        std::swap(cards[i], cards[rng.below(i + 1)]);
+    }
+    reset();
+}
@@ -10,11 +10,33 @@
 
 
 #include "Card.hpp"
+#include "Random.hpp"
 #include <array>
 #include <string>
 
 class Pack {
 public:
+  // Number of cards in a Pack
+  static const int PACK_SIZE = 24;
+
+  // A reordering of the Pack: after applying perm, position i holds the
+  // card that was at position perm[i].
+  using Permutation = std::array<unsigned char, PACK_SIZE>;
+
+  // EFFECTS: Returns the permutation that leaves the Pack unchanged
+  static constexpr Permutation identity();
+
+  // EFFECTS: Returns the permutation applied by one in shuffle: the bottom
+  //          half and the top half interleaved, bottom card first.
+  static constexpr Permutation in_shuffle();
+
+  // EFFECTS: Returns the permutation equal to applying first, then second
+  static constexpr Permutation compose(const Permutation &first,
+                                       const Permutation &second);
+
+  // EFFECTS: Returns the permutation equal to applying perm n times
+  static constexpr Permutation repeat(const Permutation &perm, int n);
+
   // EFFECTS: Initializes the Pack to be in the following standard order:
   //          the cards of the lowest suit arranged from lowest rank to
   //          highest rank, followed by the cards of the next lowest suit
@@ -43,13 +65,58 @@ public:
   //          https://en.wikipedia.org/wiki/In_shuffle.
   void shuffle();
 
+  // REQUIRES: perm holds each position 0 to PACK_SIZE - 1 exactly once
+  // EFFECTS: Reorders the Pack by perm in a single pass and resets the
+  //          next index.
+  void permute(const Permutation &perm);
+
+  // MODIFIES: rng
+  // EFFECTS: Shuffles the Pack uniformly at random with a Fisher-Yates
+  //          shuffle driven by rng, and resets the next index.  The same
+  //          starting order and rng position always give the same result.
+  void shuffle(Rng &rng);
+
   // EFFECTS: returns true if there are no more cards left in the pack
   bool empty() const;
 
 private:
-  static const int PACK_SIZE = 24;
   std::array<Card, PACK_SIZE> cards;
   int next; //index of next card to be dealt
 };
 
+constexpr Pack::Permutation Pack::identity() {
+  Permutation perm{};
+  for (int i = 0; i < PACK_SIZE; ++i) {
+    perm[i] = static_cast<unsigned char>(i);
+  }
+  return perm;
+}
+
+constexpr Pack::Permutation Pack::in_shuffle() {
+  Permutation perm{};
+  const int mid = PACK_SIZE / 2;
+  for (int k = 0; k < mid; ++k) {
+    perm[2 * k] = static_cast<unsigned char>(mid + k);
+    perm[2 * k + 1] = static_cast<unsigned char>(k);
+  }
+  return perm;
+}
+
+constexpr Pack::Permutation Pack::compose(const Permutation &first,
+                                          const Permutation &second) {
+  Permutation perm{};
+  for (int i = 0; i < PACK_SIZE; ++i) {
+    perm[i] = first[second[i]];
+  }
+  return perm;
+}
+
+constexpr Pack::Permutation Pack::repeat(const Permutation &perm, int n) {
+  Permutation result = identity();
+  for (int i = 0; i < n; ++i) {
+    result = compose(result, perm);
+  }
+  return result;
+}
+
 #endif // PACK_HPP
@@ -101,4 +101,74 @@ TEST(test_pack_shuffle_after_partial_deal) {
     ASSERT_FALSE(pack.empty());
 }
 
+TEST(test_pack_shuffle_matches_in_shuffles) {
+    Pack shuffled;
+    Pack stepped;
+    shuffled.shuffle();
+    for (int i = 0; i < 7; ++i) {
+        stepped.permute(Pack::in_shuffle());
+    }
+    for (int i = 0; i < 24; ++i) {
+        ASSERT_EQUAL(shuffled.deal_one(), stepped.deal_one());
+    }
+}
+
+TEST(test_pack_in_shuffle_order) {
+    Pack pack;
+    pack.permute(Pack::in_shuffle());
+    // Bottom half first: the Nine of Clubs is card 12 of the standard pack
+    ASSERT_EQUAL(pack.deal_one(), Card(NINE, CLUBS));
+    ASSERT_EQUAL(pack.deal_one(), Card(NINE, SPADES));
+}
+
+TEST(test_pack_permutation_compose) {
+    const Pack::Permutation twice = Pack::repeat(Pack::in_shuffle(), 2);
+    ASSERT_TRUE(Pack::compose(Pack::in_shuffle(), Pack::in_shuffle()) == twice);
+    ASSERT_TRUE(Pack::compose(twice, Pack::identity()) == twice);
+    // In shuffles of 24 cards return to the start after 20 rounds
+    ASSERT_TRUE(Pack::repeat(Pack::in_shuffle(), 20) == Pack::identity());
+}
+
+TEST(test_pack_random_shuffle_reproducible) {
+    Pack a;
+    Pack b;
+    Rng rng_a(42, 3);
+    Rng rng_b(42, 3);
+    a.shuffle(rng_a);
+    b.shuffle(rng_b);
+    set<int> seen;
+    for (int i = 0; i < 24; ++i) {
+        Card c = a.deal_one();
+        ASSERT_EQUAL(c, b.deal_one());
+        seen.insert(c.get_index());
+    }
+    ASSERT_EQUAL(seen.size(), 24u);
+}
+
+TEST(test_pack_random_shuffle_streams_differ) {
+    Pack a;
+    Pack b;
+    Rng rng_a(42, 0);
+    Rng rng_b(42, 1);
+    a.shuffle(rng_a);
+    b.shuffle(rng_b);
+    bool differ = false;
+    for (int i = 0; i < 24; ++i) {
+        differ |= a.deal_one() != b.deal_one();
+    }
+    ASSERT_TRUE(differ);
+}
+
+TEST(test_rng_counter_replay) {
+    Rng rng(7);
+    rng.next();
+    uint64_t position = rng.get_counter();
+    uint64_t value = rng.next();
+    rng.set_counter(position);
+    ASSERT_EQUAL(rng.next(), value);
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(rng.below(24) < 24u);
+    }
+}
+
 TEST_MAIN()
\ No newline at end of file
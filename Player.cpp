@@ -1,12 +1,60 @@
 // Player.cpp
 #include "Player.hpp"
+#include "BidTable.hpp"
 #include "Card.hpp"
+#include "EndgameTable.hpp"
+#include "Hand.hpp"
+#include "Ismcts.hpp"
+#include "MonteCarlo.hpp"
+#include "PlayerView.hpp"
 #include <iostream>
 #include <vector>
 #include <cassert>
 
 using namespace std;
 
+// Round 1 order up if you have 2 or more trump face cards.
+// Round 2 dealer picks next suit, others pick if they have one.
+bool simple_make_trump(Hand hand, const Card &upcard, bool is_dealer,
+                       int round, Suit &order_up_suit) {
+  const Suit up_suit   = upcard.get_suit();
+  const Suit next_suit = Suit_next(up_suit);
+
+  if (round == 1) {
+    if (hand.trump_cards(up_suit).face_or_ace().size() >= 2) {
+      order_up_suit = up_suit;
+      return true;
+    }
+    return false;
+  }
+
+  // round == 2
+  if (is_dealer || !hand.trump_cards(next_suit).empty()) {
+    order_up_suit = next_suit; // dealer: screw-the-dealer
+    return true;
+  }
+  return false;
+}
+
+// Dealer discards the LOWEST by Card_less with trump = upcard suit
+Card simple_discard(Hand hand, const Card &upcard) {
+  return hand.lowest(upcard.get_suit());
+}
+
+// Lead highest non-trump by operator< (rank/suit tie: D>C>H>S).
+// If no non-trump, lead highest trump by Card_less (trump-aware).
+Card simple_lead(Hand hand, Suit trump) {
+  const Hand non_trump = hand.without(hand.trump_cards(trump));
+  return non_trump.empty() ? hand.highest(trump) : non_trump.last();
+}
+
+// If can follow suit: play the HIGHEST of the led suit (Card_less).
+// Else: play the LOWEST overall by Card_less, which prefers non-trump.
+Card simple_play(Hand hand, const Card &led_card, Suit trump) {
+  const Hand follow = hand.in_suit(led_card.get_suit(trump), trump);
+  return follow.empty() ? hand.lowest(trump) : follow.highest(trump);
+}
+
 class SimplePlayer : public Player {
 public:
   explicit SimplePlayer(const string &name_in) : name(name_in) {}
@@ -16,125 +64,171 @@ public:
   }
 
   void add_card(const Card &c) override {
-    hand.push_back(c);
+    hand.add(c);
   }
 
-  // Round 1 order up if you have  2more than trump.
-  // round 2 dealer picks next suit others pick if they have one
   bool make_trump(const Card &upcard, bool is_dealer, int round,
                   Suit &order_up_suit) const override {
-    const Suit up_suit   = upcard.get_suit();
-    const Suit next_suit = Suit_next(up_suit);
-
-    if (round == 1) {
-  int trump_faces = 0;
-  for (const auto &c : hand) {
-    if (c.is_trump(up_suit) && c.is_face_or_ace()) {
-      ++trump_faces;
-    }
+    return simple_make_trump(hand, upcard, is_dealer, round, order_up_suit);
   }
-  if (trump_faces >= 2) {
-    order_up_suit = up_suit;
-    return true;
+
+  Card add_and_discard(const Card &upcard) override {
+    hand.add(upcard);
+    const Card discard = simple_discard(hand, upcard);
+    hand.remove(discard);
+    return discard;
   }
-  return false;
-}
 
-    // round == 2
-    if (is_dealer) {
-      order_up_suit = next_suit; // screw-the-dealer
-      return true;
-    } else {
-      for (const auto &c : hand) {
-        if (c.is_trump(next_suit)) {
-          order_up_suit = next_suit;
-          return true;
-        }
-      }
-      return false;
-    }
+  Card lead_card(Suit trump) override {
+    const Card led = simple_lead(hand, trump);
+    hand.remove(led);
+    return led;
   }
 
-  // Dealer picks up upcard and discards the LOWEST by Card_less with trump = upcard suit
-  void add_and_discard(const Card &upcard) override {
-    hand.push_back(upcard);
-    const Suit trump = upcard.get_suit();
-    auto min_it = hand.begin();
-    for (auto it = hand.begin(); it != hand.end(); ++it) {
-      if (Card_less(*it, *min_it, trump)) min_it = it;
-    }
-    hand.erase(min_it);
+  Card play_card(const Card &led_card, Suit trump) override {
+    const Card played = simple_play(hand, led_card, trump);
+    hand.remove(played);
+    return played;
   }
 
-  // Lead highest non-trump by operator< (rank/suit tie: D>C>H>S).
-  // If no non-trump, lead highest trump by Card_less (trump-aware).
-  Card lead_card(Suit trump) override {
-    auto best = hand.end();
+protected:
+  Hand hand;
 
-    // Highest non-trump using operator<
-    for (auto it = hand.begin(); it != hand.end(); ++it) {
-      if (!it->is_trump(trump)) {
-        if (best == hand.end() || (*best < *it)) best = it;
-      }
-    }
+private:
+  string name;
+};
 
-    // If none, highest overall (trump) using Card_less
-    if (best == hand.end()) {
-      for (auto it = hand.begin(); it != hand.end(); ++it) {
-        if (best == hand.end() || Card_less(*best, *it, trump)) best = it;
-      }
-    }
+// Bids and discards like SimplePlayer, and keeps a PlayerView of the hand
+// for strategies that search over what they cannot see
+class ViewingPlayer : public SimplePlayer {
+public:
+  explicit ViewingPlayer(const string &name_in) : SimplePlayer(name_in) {}
 
-    Card led = *best;
-    hand.erase(best);
-    return led;
+  Card add_and_discard(const Card &upcard) override {
+    const Card discard = SimplePlayer::add_and_discard(upcard);
+    view.discard(discard);
+    return discard;
   }
 
-  // If can follow suit: play the HIGHEST of the led suit (Card_less).
-  // Else: play the LOWEST overall using operator< (matches test expectations).
-  Card play_card(const Card &led_card, Suit trump) override {
-    const Suit led_suit = led_card.get_suit(trump);
-
-    // Try to follow suit: play highest of led suit
-    auto candidate = hand.end();
-    for (auto it = hand.begin(); it != hand.end(); ++it) {
-      if (it->get_suit(trump) == led_suit) {
-        if (candidate == hand.end() || Card_less(*candidate, *it, trump)) {
-          candidate = it;
-        }
-      }
-    }
-    if (candidate != hand.end()) {
-      Card played = *candidate;
-      hand.erase(candidate);
-      return played;
-    }
+  void observe_deal(int seat, int dealer, const Card &upcard) override {
+    view.deal(seat, dealer, upcard);
+  }
 
-    /// Can't follow: play the lowest overall using Card_less,
-    auto better_throw = [trump](const Card &a, const Card &b) {
-    bool at = a.is_trump(trump), bt = b.is_trump(trump);
-    if (at != bt) return !at && bt; // prefer non-trump (a) over trump (b)
+  void observe_trump(const TrumpEvent &e) override {
+    view.trump_made(e);
+  }
 
-    bool a_lt_b = Card_less(a, b, trump);
-    bool b_lt_a = Card_less(b, a, trump);
-    if (a_lt_b != b_lt_a) return a_lt_b; // a strictly weaker than b
+  void observe_play(const PlayEvent &e) override {
+    view.play(e);
+  }
+
+protected:
+  PlayerView view;
+
+  // A seed unique to this seat's next decision
+  uint64_t next_seed() const {
+    return uint64_t(view.get_seat()) << 32 | ++decisions;
+  }
 
-    // Equal by Card_less: fall back to plain ordering (rank, then suit)
-    return a < b;
-    };
+private:
+  mutable uint64_t decisions = 0;
+};
 
-    auto min_it = hand.begin();
-    for (auto it = hand.begin(); it != hand.end(); ++it) {
-        if (better_throw(*it, *min_it)) min_it = it;
+// Picks every card to lead or play by perfect-information Monte Carlo
+// search over deals that agree with what it has seen this hand.
+class MonteCarloPlayer : public ViewingPlayer {
+public:
+  MonteCarloPlayer(const string &name_in, const MonteCarloOptions &opts_in)
+    : ViewingPlayer(name_in), search(opts_in) {}
+
+  Card lead_card(Suit) override {
+    return choose();
+  }
+
+  Card play_card(const Card &, Suit) override {
+    return choose();
+  }
+
+private:
+  MonteCarloSearch search;
+
+  Card choose() {
+    const Card c = search.choose_card(view, hand, next_seed());
+    hand.remove(c);
+    return c;
+  }
+};
+
+// Bids and picks every card by information-set Monte Carlo tree search,
+// returning the best move found by each decision's deadline
+class IsmctsPlayer : public ViewingPlayer {
+public:
+  IsmctsPlayer(const string &name_in, const IsmctsOptions &opts_in)
+    : ViewingPlayer(name_in), search(opts_in) {}
+
+  bool make_trump(const Card &, bool, int round,
+                  Suit &order_up_suit) const override {
+    return search.choose_bid(view, hand, round, order_up_suit, next_seed());
+  }
+
+  Card lead_card(Suit) override {
+    return choose();
+  }
+
+  Card play_card(const Card &, Suit) override {
+    return choose();
+  }
+
+private:
+  // make_trump is const, but searching reuses the tree's storage
+  mutable IsmctsSearch search;
+
+  Card choose() {
+    const Card c = search.choose_card(view, hand, next_seed());
+    hand.remove(c);
+    return c;
+  }
+};
+
+// Bids from the precomputed bid table and plays like SimplePlayer
+class BidTablePlayer : public ViewingPlayer {
+public:
+  BidTablePlayer(const string &name_in, const BidTable &table_in)
+    : ViewingPlayer(name_in), table(table_in) {}
+
+  // Round 1 order up if the upcard's suit makes often enough.  Round 2
+  // call the best other suit if it does, and the dealer always calls it.
+  bool make_trump(const Card &upcard, bool is_dealer, int round,
+                  Suit &order_up_suit) const override {
+    const int position = (view.get_seat() - view.get_dealer() + 3) % 4;
+    const Suit up_suit = upcard.get_suit();
+    Suit best = up_suit;
+    double best_chance = -1;
+    for (int s = SPADES; s <= DIAMONDS; ++s) {
+      if ((s == up_suit) != (round == 1)) {
+        continue;
+      }
+      const Suit suit = static_cast<Suit>(s);
+      const double chance =
+          table.win_probability(hand, upcard, position, suit);
+      if (chance > best_chance) {
+        best = suit;
+        best_chance = chance;
+      }
     }
-    Card played = *min_it;
-    hand.erase(min_it);
-    return played;
+    if (best_chance < BID_THRESHOLD && !(is_dealer && round == 2)) {
+      return false;
+    }
+    order_up_suit = best;
+    return true;
   }
 
 private:
-  string name;
-  vector<Card> hand;
+  // Chance of making trump needed to bid: making scores 1 and being
+  // euchred costs 2, so a bid pays once p - 2 (1 - p) > 0, at p = 2/3
+  static constexpr double BID_THRESHOLD = 2.0 / 3;
+
+  const BidTable &table;
 };
 
 class Human : public Player {
@@ -147,7 +241,7 @@ public:
   bool make_trump(const Card &, bool, int, Suit &) const override {
     assert(false); return false;
   }
-  void add_and_discard(const Card &) override { assert(false); }
+  Card add_and_discard(const Card &) override { assert(false); return Card(); }
   Card lead_card(Suit) override { assert(false); return Card(); }
   Card play_card(const Card &, Suit) override { assert(false); return Card(); }
 
@@ -156,9 +250,58 @@ private:
   vector<Card> hand;
 };
 
+// Strategies that take options after a colon, e.g. "MonteCarlo:200:4" or
+// "BidTable:tables/bid_table.bin"
+static const string MONTE_CARLO = "MonteCarlo";
+static const string ISMCTS = "Ismcts";
+static const string BID_TABLE = "BidTable";
+
+// Table BidTable players read unless given a path
+static const string DEFAULT_BID_TABLE = "bid_table.bin";
+
+// Returns true if strategy is name, or name and a colon and a spec, which
+// it puts in spec
+static bool strategy_spec(const string &strategy, const string &name,
+                          string &spec) {
+  if (strategy.compare(0, name.size(), name) != 0) {
+    return false;
+  }
+  spec = strategy.substr(name.size());
+  if (spec.empty()) {
+    return true;
+  }
+  spec.erase(0, 1);
+  return strategy[name.size()] == ':' && !spec.empty();
+}
+
 Player * Player_factory(const std::string &name, const std::string &strategy) {
   if (strategy == "Simple") return new SimplePlayer(name);
   if (strategy == "Human")  return new Human(name);
+  string spec;
+  if (strategy_spec(strategy, MONTE_CARLO, spec)) {
+    MonteCarloOptions opts;
+    if (!opts.parse(spec)) {
+      return nullptr;
+    }
+    // Endgame results are exact, so the players choose the same cards with
+    // the table as without it, only faster
+    if (!opts.endgame_filename.empty()) {
+      opts.endgames = EndgameTable::shared(opts.endgame_filename);
+      if (!opts.endgames) {
+        return nullptr;
+      }
+    }
+    return new MonteCarloPlayer(name, opts);
+  }
+  if (strategy_spec(strategy, ISMCTS, spec)) {
+    IsmctsOptions opts;
+    return opts.parse(spec) ? new IsmctsPlayer(name, opts) : nullptr;
+  }
+  if (strategy_spec(strategy, BID_TABLE, spec)) {
+    const BidTable *table =
+        BidTable::shared(spec.empty() ? DEFAULT_BID_TABLE : spec);
+    return table ? new BidTablePlayer(name, *table) : nullptr;
+  }
   return nullptr;
 }
 
@@ -11,9 +11,20 @@
 
 
 #include "Card.hpp"
+#include "GameSink.hpp"
+#include "Hand.hpp"
 #include <string>
 #include <vector>
 
+// The kinds of decision a Player makes
+enum Decision {
+  DECISION_MAKE_TRUMP,
+  DECISION_ADD_AND_DISCARD,
+  DECISION_LEAD_CARD,
+  DECISION_PLAY_CARD,
+  NUM_DECISIONS
+};
+
 class Player {
  public:
   //EFFECTS returns player's name
@@ -32,8 +43,11 @@ class Player {
                           int round, Suit &order_up_suit) const = 0;
 
   //REQUIRES Player has at least one card
-  //EFFECTS  Player adds one card to hand and removes one card from hand.
-  virtual void add_and_discard(const Card &upcard) = 0;
+  //EFFECTS  Player adds one card to hand and removes one card from hand,
+  //  and returns the card removed.  The original interface returned
+  //  nothing, but Game must know the discard to keep track of the dealer's
+  //  cards and check every card they play.
+  virtual Card add_and_discard(const Card &upcard) = 0;
 
   //REQUIRES Player has at least one card
   //EFFECTS  Leads one Card from Player's hand according to their strategy
@@ -46,6 +60,18 @@ class Player {
   //  The card is removed from the player's hand.
   virtual Card play_card(const Card &led_card, Suit trump) = 0;
 
+  //EFFECTS Called once the cards are dealt and the upcard turned, with
+  //  this Player's seat and the dealer's seat (0 to 3).  Players that track
+  //  the hand override this and the observe functions below; the defaults
+  //  ignore what they are told.
+  virtual void observe_deal(int seat, int dealer, const Card &upcard) {}
+
+  //EFFECTS Called when bidding is over
+  virtual void observe_trump(const TrumpEvent &e) {}
+
+  //EFFECTS Called after every card is led or played, this Player's included
+  virtual void observe_play(const PlayEvent &e) {}
+
   // Maximum number of cards in a player's hand
   static const int MAX_HAND_SIZE = 5;
 
@@ -60,6 +86,27 @@ class Player {
 //Don't forget to call "delete" on each Player* after the game is over
 Player * Player_factory(const std::string &name, const std::string &strategy);
 
+// The Simple strategy as functions of a hand, for strategies that play
+// out hands for other seats in simulation
+
+//MODIFIES order_up_suit
+//EFFECTS Returns true and sets order_up_suit if a Simple player holding
+//  hand would order up in this round
+bool simple_make_trump(Hand hand, const Card &upcard, bool is_dealer,
+                       int round, Suit &order_up_suit);
+
+//REQUIRES hand holds upcard
+//EFFECTS Returns the card a Simple dealer holding hand discards
+Card simple_discard(Hand hand, const Card &upcard);
+
+//REQUIRES hand is not empty
+//EFFECTS Returns the card a Simple player holding hand leads
+Card simple_lead(Hand hand, Suit trump);
+
+//REQUIRES hand is not empty
+//EFFECTS Returns the card a Simple player holding hand plays to led_card
+Card simple_play(Hand hand, const Card &led_card, Suit trump);
+
 //EFFECTS: Prints player's name to os
 std::ostream & operator<<(std::ostream &os, const Player &p);
 
@@ -0,0 +1,153 @@
+// PlayerView.cpp
+#include "PlayerView.hpp"
+#include "Player.hpp"
+
+using namespace std;
+
+// Attempts at meeting every seat's void suits before giving up on them
+static const int VOID_ATTEMPTS = 8;
+
+void PlayerView::deal(int seat_in, int dealer_in, const Card &upcard_in) {
+  seat = seat_in;
+  dealer = dealer_in;
+  upcard = upcard_in;
+  upcard_with_dealer = false;
+  seen = Hand();
+  plays.fill(0);
+  voids.fill(0);
+  tricks.fill(0);
+  trick = Position();
+  trick.leader = (dealer + 1) % 4;
+}
+
+void PlayerView::trump_made(const TrumpEvent &e) {
+  trick.trump = e.trump;
+  maker = e.maker;
+  if (e.round == 1) {
+    upcard_with_dealer = dealer != seat;
+  } else {
+    seen.add(upcard); // turned down
+  }
+}
+
+void PlayerView::discard(const Card &c) {
+  seen.add(c);
+}
+
+void PlayerView::play(const PlayEvent &e) {
+  if (e.lead) {
+    trick.leader = e.seat;
+    trick.played = 0;
+  } else {
+    const Suit led = trick.trick[0].get_suit(trick.trump);
+    if (e.card.get_suit(trick.trump) != led) {
+      voids[e.seat] |= 1u << led;
+    }
+  }
+  trick.trick[trick.played] = e.card;
+  trick.played = (trick.played + 1) % 4;
+  seen.add(e.card);
+  ++plays[e.seat];
+  if (trick.played == 0) {
+    int best = 0;
+    for (int i = 1; i < 4; ++i) {
+      if (Card_less(trick.trick[best], trick.trick[i], trick.trick[0],
+                    trick.trump)) {
+        best = i;
+      }
+    }
+    ++tricks[(trick.leader + best) % 2];
+  }
+}
+
+// The unknown cards other may hold, given the suits it has shown out of
+Hand PlayerView::eligible(int other, Hand unknown) const {
+  for (int s = SPADES; s <= DIAMONDS; ++s) {
+    if (voids[other] & (1u << s)) {
+      unknown = unknown.without(Hand::suit_cards(static_cast<Suit>(s),
+                                                 trick.trump));
+    }
+  }
+  return unknown;
+}
+
+Position PlayerView::sample(Hand own, Rng &rng) const {
+  Position pos = trick;
+  if (pos.played == 0) {
+    pos.leader = seat;
+  }
+  pos.hands.fill(Hand());
+  pos.hands[seat] = own;
+  Hand unknown = Hand::full().without(own).without(seen);
+
+  array<int, 4> need;
+  for (int other = 0; other < 4; ++other) {
+    need[other] = other == seat ? 0 : Player::MAX_HAND_SIZE - plays[other];
+  }
+  // The dealer still holds a picked-up upcard unless they played it or
+  // showed out of its suit, in which case it was their discard
+  if (upcard_with_dealer && unknown.contains(upcard)) {
+    unknown.remove(upcard);
+    if (!(voids[dealer] & (1u << upcard.get_suit(trick.trump)))) {
+      pos.hands[dealer].add(upcard);
+      --need[dealer];
+    }
+  }
+
+  for (int attempt = 0; attempt < VOID_ATTEMPTS; ++attempt) {
+    if (deal_unknown(unknown, need, true, rng, pos)) {
+      return pos;
+    }
+  }
+  deal_unknown(unknown, need, false, rng, pos);
+  return pos;
+}
+
+array<Hand, 4> PlayerView::sample_deal(Hand own, Rng &rng) const {
+  Position pos;
+  pos.hands.fill(Hand());
+  pos.hands[seat] = own;
+  const Hand unknown = Hand::full().without(own).without(Hand::of(upcard));
+  array<int, 4> need;
+  for (int other = 0; other < 4; ++other) {
+    need[other] = other == seat ? 0 : Player::MAX_HAND_SIZE;
+  }
+  deal_unknown(unknown, need, false, rng, pos);
+  return pos.hands;
+}
+
+// Gives each other seat its need of random unknown cards, most constrained
+// seat first.  Returns false if some seat runs out of eligible cards.
+bool PlayerView::deal_unknown(Hand unknown, const array<int, 4> &need,
+                              bool use_voids, Rng &rng, Position &pos) const {
+  array<int, 4> order = {{0, 1, 2, 3}};
+  array<Hand, 4> dealt;
+  for (int i = 1; i < 4; ++i) {
+    for (int j = i; j > 0; --j) {
+      if (__builtin_popcount(voids[order[j]])
+          <= __builtin_popcount(voids[order[j - 1]])) {
+        break;
+      }
+      swap(order[j], order[j - 1]);
+    }
+  }
+  for (int other : order) {
+    for (int c = 0; c < need[other]; ++c) {
+      const Hand pool = use_voids ? eligible(other, unknown) : unknown;
+      if (pool.empty()) {
+        return false;
+      }
+      uint32_t bits = pool.get_bits();
+      for (uint32_t skip = rng.below(pool.size()); skip > 0; --skip) {
+        bits &= bits - 1;
+      }
+      const Hand pick(bits & (0u - bits));
+      dealt[other] = dealt[other] | pick;
+      unknown = unknown.without(pick);
+    }
+  }
+  for (int other = 0; other < 4; ++other) {
+    pos.hands[other] = pos.hands[other] | dealt[other];
+  }
+  return true;
+}
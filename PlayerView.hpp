@@ -0,0 +1,91 @@
+#ifndef PLAYER_VIEW_HPP
+#define PLAYER_VIEW_HPP
+/* PlayerView.hpp
+ *
+ * What one seat knows about the hand being played, and random deals of
+ * the unseen cards that agree with it
+ */
+
+#include "Card.hpp"
+#include "GameSink.hpp"
+#include "Hand.hpp"
+#include "Random.hpp"
+#include "Solver.hpp"
+#include <array>
+
+class PlayerView {
+public:
+  //MODIFIES this PlayerView
+  //EFFECTS Starts a new hand for seat, after the deal
+  void deal(int seat_in, int dealer_in, const Card &upcard_in);
+
+  //MODIFIES this PlayerView
+  //EFFECTS Records the outcome of bidding
+  void trump_made(const TrumpEvent &e);
+
+  //MODIFIES this PlayerView
+  //EFFECTS Records the card this seat discarded after picking up the upcard
+  void discard(const Card &c);
+
+  //MODIFIES this PlayerView
+  //EFFECTS Records a card led or played by any seat, this one included
+  void play(const PlayEvent &e);
+
+  //EFFECTS Returns this seat
+  int get_seat() const { return seat; }
+
+  //EFFECTS Returns the seat that dealt this hand
+  int get_dealer() const { return dealer; }
+
+  //EFFECTS Returns the card turned up after the deal
+  const Card & get_upcard() const { return upcard; }
+
+  //EFFECTS Returns the trump suit of the hand
+  Suit get_trump() const { return trick.trump; }
+
+  //EFFECTS Returns the seat that made trump
+  int get_maker() const { return maker; }
+
+  //EFFECTS Returns the tricks each team has taken so far this hand
+  const std::array<int, 2> & get_tricks() const { return tricks; }
+
+  //REQUIRES own holds this seat's cards and it is this seat's turn
+  //EFFECTS Returns the cards of own this seat may lead or play now
+  Hand legal(Hand own) const {
+    return trick.played == 0 ? own : legal_moves(own, trick.trick[0],
+                                                 trick.trump);
+  }
+
+  //REQUIRES own holds this seat's five cards and bidding is not over
+  //MODIFIES rng
+  //EFFECTS Returns every seat's hand with the cards other than own and
+  //  the upcard dealt at random to the other seats
+  std::array<Hand, 4> sample_deal(Hand own, Rng &rng) const;
+
+  //REQUIRES own holds this seat's cards and it is this seat's turn
+  //MODIFIES rng
+  //EFFECTS Returns the current Position with the cards this seat cannot see
+  //  dealt at random to the other seats.  Each seat gets the right number
+  //  of cards, no card of a suit it has shown out of, and the dealer keeps
+  //  a picked-up upcard.  If the suit constraints cannot be met after a few
+  //  tries they are dropped.
+  Position sample(Hand own, Rng &rng) const;
+
+private:
+  int seat = 0;
+  int dealer = 0;
+  int maker = 0;
+  Card upcard;
+  bool upcard_with_dealer = false; // another seat picked up the upcard
+  Hand seen;                       // played, discarded or turned down
+  std::array<int, 4> plays;        // cards each seat has played this hand
+  std::array<unsigned, 4> voids;   // bit s: seat has shown out of suit s
+  std::array<int, 2> tricks;       // tricks each team has taken
+  Position trick;                  // leader and cards of the current trick
+
+  Hand eligible(int other, Hand unknown) const;
+  bool deal_unknown(Hand unknown, const std::array<int, 4> &need,
+                    bool use_voids, Rng &rng, Position &pos) const;
+};
+
+#endif // PLAYER_VIEW_HPP
@@ -212,9 +212,10 @@ TEST(Lead_card_add_discard){
   bob->add_card(Card(KING, HEARTS));
 
   // Bob adds a card to his hand and discards one card
-  bob->add_and_discard(
+  const Card discarded = bob->add_and_discard(
     Card(ACE, HEARTS) // upcard
   );
+  ASSERT_EQUAL(discarded, Card(NINE, CLUBS));
 
   // Bob leads
   Card card_led = bob->lead_card(HEARTS);
@@ -315,4 +316,22 @@ TEST(play_card_cantfollow){
   delete bob;
 }
 
+TEST(test_player_factory_search_specs) {
+  for (const char *spec : {"MonteCarlo", "MonteCarlo:20", "MonteCarlo:5ms",
+                           "MonteCarlo:20:2", "MonteCarlo:5ms:4", "Ismcts",
+                           "Ismcts:200", "Ismcts:5ms"}) {
+    Player *p = Player_factory("Ann", spec);
+    ASSERT_TRUE(p != nullptr);
+    ASSERT_EQUAL(p->get_name(), "Ann");
+    delete p;
+  }
+  for (const char *spec : {"MonteCarloX", "MonteCarlo:", "MonteCarlo:0",
+                           "MonteCarlo:5msx", "MonteCarlo:20:0",
+                           "MonteCarlo:20:1:",
+                           "MonteCarlo:20:1:no_such_endgame_table.bin", "Ismcts:",
+                           "Ismcts:0", "Ismcts:5s", "Random"}) {
+    ASSERT_TRUE(Player_factory("Ann", spec) == nullptr);
+  }
+}
+
 TEST_MAIN()
\ No newline at end of file
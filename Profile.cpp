@@ -0,0 +1,146 @@
+// Profile.cpp
+#include "Profile.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+static const char *const PHASE_NAMES[NUM_PHASES] = {
+  "game", "shuffle", "deal", "make_trump", "play_hand", "scoring", "output",
+  "observe", "bid decision", "discard decision", "lead decision",
+  "play decision"
+};
+
+static const char *const COUNTER_NAMES[NUM_COUNTERS] = {
+  "hands", "bids", "tricks", "cards"
+};
+
+ProfileTotals & ProfileTotals::operator+=(const ProfileTotals &other) {
+  for (int p = 0; p < NUM_PHASES; ++p) {
+    ns[p] += other.ns[p];
+    calls[p] += other.calls[p];
+  }
+  for (int c = 0; c < NUM_COUNTERS; ++c) {
+    counts[c] += other.counts[c];
+  }
+  for (int seat = 0; seat < 4; ++seat) {
+    seat_ns[seat] += other.seat_ns[seat];
+  }
+  threads += other.threads;
+  return *this;
+}
+
+// The threads now recording, and the sums of those that have finished.
+// Prints the grand total when the process exits, after every thread's
+// ThreadProfile has been destroyed.
+class ProfileRegistry {
+public:
+  void add(const ThreadProfile *profile) {
+    lock_guard<mutex> guard(lock);
+    live.push_back(profile);
+  }
+
+  void retire(const ThreadProfile *profile) {
+    lock_guard<mutex> guard(lock);
+    finished += profile->snapshot();
+    live.erase(find(live.begin(), live.end(), profile));
+  }
+
+  ProfileTotals totals() {
+    lock_guard<mutex> guard(lock);
+    ProfileTotals sum = finished;
+    for (const ThreadProfile *profile : live) {
+      sum += profile->snapshot();
+    }
+    return sum;
+  }
+
+  ~ProfileRegistry() {
+#ifdef EUCHRE_PROFILE
+    print_profile(cerr, totals());
+#endif
+  }
+
+private:
+  mutex lock;
+  vector<const ThreadProfile *> live;
+  ProfileTotals finished;
+};
+
+static ProfileRegistry & registry() {
+  static ProfileRegistry instance;
+  return instance;
+}
+
+ThreadProfile::ThreadProfile() {
+  registry().add(this);
+}
+
+ThreadProfile::~ThreadProfile() {
+  registry().retire(this);
+}
+
+ProfileTotals ThreadProfile::snapshot() const {
+  ProfileTotals totals;
+  for (int p = 0; p < NUM_PHASES; ++p) {
+    totals.ns[p] = ns[p].load(memory_order_relaxed);
+    totals.calls[p] = calls[p].load(memory_order_relaxed);
+  }
+  for (int c = 0; c < NUM_COUNTERS; ++c) {
+    totals.counts[c] = counts[c].load(memory_order_relaxed);
+  }
+  for (int seat = 0; seat < 4; ++seat) {
+    totals.seat_ns[seat] = seat_ns[seat].load(memory_order_relaxed);
+  }
+  totals.threads = 1;
+  return totals;
+}
+
+ProfileTotals profile_totals() {
+  return registry().totals();
+}
+
+// Prints one row of the table, leaving out the calls if there are none
+static void print_row(ostream &os, const string &name, uint64_t ns,
+                      uint64_t calls) {
+  os << left << setw(20) << name << right << setw(12);
+  if (calls) {
+    os << calls;
+  } else {
+    os << "";
+  }
+  os << fixed << setprecision(3) << setw(14) << ns / 1e6;
+  if (calls) {
+    os << setprecision(1) << setw(12) << double(ns) / calls;
+  }
+  os << '\n';
+}
+
+void print_profile(ostream &os, const ProfileTotals &totals) {
+  os << "profile over " << totals.threads << " thread(s)\n"
+     << left << setw(20) << "phase" << right << setw(12) << "calls"
+     << setw(14) << "total ms" << setw(12) << "ns/call" << '\n';
+  for (int p = 0; p < NUM_PHASES; ++p) {
+    print_row(os, PHASE_NAMES[p], totals.ns[p], totals.calls[p]);
+  }
+
+  // Phases nest, so engine time is the game less what it calls out to
+  uint64_t outside = totals.ns[PHASE_OUTPUT] + totals.ns[PHASE_OBSERVE];
+  for (ProfilePhase p : DECISION_PHASES) {
+    outside += totals.ns[p];
+  }
+  const uint64_t game = totals.ns[PHASE_GAME];
+  print_row(os, "engine", game > outside ? game - outside : 0,
+            totals.calls[PHASE_GAME]);
+  for (int seat = 0; seat < 4; ++seat) {
+    print_row(os, "seat " + to_string(seat) + " thinking",
+              totals.seat_ns[seat], 0);
+  }
+  for (int c = 0; c < NUM_COUNTERS; ++c) {
+    os << left << setw(20) << COUNTER_NAMES[c] << right << setw(12)
+       << totals.counts[c] << '\n';
+  }
+  os << flush;
+}
@@ -0,0 +1,145 @@
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+/* Profile.hpp
+ *
+ * Optional timers and counters for the phases of a game and the players'
+ * decisions.  Built with EUCHRE_PROFILE defined, each thread adds to its
+ * own totals and the totals over all threads are printed to stderr at
+ * exit.  Without it the PROFILE_ macros expand to nothing, or to the
+ * expression they wrap.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+enum ProfilePhase {
+  PHASE_GAME,       // all of Game::play
+  PHASE_SHUFFLE,
+  PHASE_DEAL,       // dealing, including Player::add_card
+  PHASE_MAKE_TRUMP, // both rounds of bidding, including the decisions
+  PHASE_PLAY_HAND,  // five tricks, including the decisions
+  PHASE_SCORING,
+  PHASE_OUTPUT,     // GameSink events
+  PHASE_OBSERVE,    // Player observe_ hooks
+  PHASE_BID,        // Player::make_trump
+  PHASE_DISCARD,    // Player::add_and_discard
+  PHASE_LEAD,       // Player::lead_card
+  PHASE_PLAY,       // Player::play_card
+  NUM_PHASES
+};
+
+enum ProfileCounter {
+  COUNT_HANDS,
+  COUNT_BIDS,
+  COUNT_TRICKS,
+  COUNT_CARDS,
+  NUM_COUNTERS
+};
+
+// The phases that are a player thinking rather than the engine working
+const ProfilePhase DECISION_PHASES[] = {PHASE_BID, PHASE_DISCARD,
+                                        PHASE_LEAD, PHASE_PLAY};
+
+// Sums over some threads
+struct ProfileTotals {
+  std::array<uint64_t, NUM_PHASES> ns = {};     // time inside each phase
+  std::array<uint64_t, NUM_PHASES> calls = {};  // times each phase ran
+  std::array<uint64_t, NUM_COUNTERS> counts = {};
+  std::array<uint64_t, 4> seat_ns = {};         // decision time by seat
+  int threads = 0;
+
+  ProfileTotals & operator+=(const ProfileTotals &other);
+};
+
+// One thread's totals.  Only that thread writes them, so adding is a plain
+// load and store; other threads may read them at any time.
+struct ThreadProfile {
+  std::array<std::atomic<uint64_t>, NUM_PHASES> ns = {};
+  std::array<std::atomic<uint64_t>, NUM_PHASES> calls = {};
+  std::array<std::atomic<uint64_t>, NUM_COUNTERS> counts = {};
+  std::array<std::atomic<uint64_t>, 4> seat_ns = {};
+
+  //EFFECTS Registers this thread's totals
+  ThreadProfile();
+
+  //EFFECTS Adds this thread's totals to those of finished threads
+  ~ThreadProfile();
+
+  static void add(std::atomic<uint64_t> &total, uint64_t amount) {
+    total.store(total.load(std::memory_order_relaxed) + amount,
+                std::memory_order_relaxed);
+  }
+
+  //EFFECTS Returns a copy of these totals
+  ProfileTotals snapshot() const;
+};
+
+//EFFECTS Returns the calling thread's totals
+inline ThreadProfile & thread_profile() {
+  thread_local ThreadProfile profile;
+  return profile;
+}
+
+//EFFECTS Returns the totals over every thread that has recorded anything
+ProfileTotals profile_totals();
+
+//EFFECTS Prints totals as a table, with engine time apart from decisions
+void print_profile(std::ostream &os, const ProfileTotals &totals);
+
+// Adds the time from construction to destruction to a phase, and for a
+// decision to the deciding seat
+class ProfileScope {
+public:
+  explicit ProfileScope(ProfilePhase phase_in, int seat_in = -1)
+    : phase(phase_in), seat(seat_in), start(Clock::now()) {}
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope & operator=(const ProfileScope &) = delete;
+
+  ~ProfileScope() {
+    const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - start).count();
+    ThreadProfile &profile = thread_profile();
+    ThreadProfile::add(profile.ns[phase], ns);
+    ThreadProfile::add(profile.calls[phase], 1);
+    if (seat >= 0) {
+      ThreadProfile::add(profile.seat_ns[seat], ns);
+    }
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+  ProfilePhase phase;
+  int seat;
+  Clock::time_point start;
+};
+
+#ifdef EUCHRE_PROFILE
+
+#define PROFILE_JOIN2(a, b) a##b
+#define PROFILE_JOIN(a, b) PROFILE_JOIN2(a, b)
+
+// Times the rest of the enclosing block as phase, for seat if given
+#define PROFILE_SCOPE(...) \
+  ProfileScope PROFILE_JOIN(profile_scope_, __LINE__)(__VA_ARGS__)
+
+// Evaluates expr, timing it as phase for seat
+#define PROFILE_CALL(phase, seat, expr) \
+  ([&]() -> decltype(auto) { ProfileScope scope(phase, seat); return expr; }())
+
+// Adds amount to counter
+#define PROFILE_COUNT(counter, amount) \
+  ThreadProfile::add(thread_profile().counts[counter], amount)
+
+#else
+
+#define PROFILE_SCOPE(...) static_cast<void>(0)
+#define PROFILE_CALL(phase, seat, expr) (expr)
+#define PROFILE_COUNT(counter, amount) static_cast<void>(0)
+
+#endif // EUCHRE_PROFILE
+
+#endif // PROFILE_HPP
@@ -0,0 +1,91 @@
+#include "Profile.hpp"
+#include "Game.hpp"
+#include "unit_test_framework.hpp"
+
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+// Built with EUCHRE_PROFILE, so the macros record.  Totals are shared by
+// the whole process, so each test compares before and after.
+
+TEST(test_profile_scope_and_count) {
+  const ProfileTotals before = profile_totals();
+  {
+    PROFILE_SCOPE(PHASE_SCORING);
+    PROFILE_COUNT(COUNT_TRICKS, 3);
+    this_thread::sleep_for(chrono::milliseconds(2));
+  }
+  const int doubled = PROFILE_CALL(PHASE_LEAD, 2, 21 * 2);
+  ASSERT_EQUAL(doubled, 42);
+
+  const ProfileTotals after = profile_totals();
+  ASSERT_EQUAL(after.calls[PHASE_SCORING], before.calls[PHASE_SCORING] + 1);
+  ASSERT_TRUE(after.ns[PHASE_SCORING] >= before.ns[PHASE_SCORING] + 2000000);
+  ASSERT_EQUAL(after.counts[COUNT_TRICKS], before.counts[COUNT_TRICKS] + 3);
+  ASSERT_EQUAL(after.calls[PHASE_LEAD], before.calls[PHASE_LEAD] + 1);
+  ASSERT_TRUE(after.seat_ns[2] >= before.seat_ns[2]);
+}
+
+TEST(test_profile_keeps_finished_threads) {
+  const ProfileTotals before = profile_totals();
+  thread worker([] {
+    PROFILE_COUNT(COUNT_BIDS, 5);
+  });
+  worker.join();
+  const ProfileTotals after = profile_totals();
+  ASSERT_EQUAL(after.counts[COUNT_BIDS], before.counts[COUNT_BIDS] + 5);
+  ASSERT_EQUAL(after.threads, before.threads + 1);
+}
+
+TEST(test_profile_counts_game_phases) {
+  vector<Player*> players;
+  for (const char *name : {"A", "B", "C", "D"}) {
+    players.push_back(Player_factory(name, "Simple"));
+  }
+  Pack pack;
+  Game game(pack, true, 10, players);
+
+  const ProfileTotals before = profile_totals();
+  game.play();
+  const ProfileTotals after = profile_totals();
+  for (Player *p : players) delete p;
+
+  const uint64_t hands =
+      after.counts[COUNT_HANDS] - before.counts[COUNT_HANDS];
+  ASSERT_TRUE(hands > 0);
+  ASSERT_EQUAL(after.calls[PHASE_GAME] - before.calls[PHASE_GAME], 1u);
+  ASSERT_EQUAL(after.calls[PHASE_PLAY_HAND] - before.calls[PHASE_PLAY_HAND],
+               hands);
+  ASSERT_EQUAL(after.counts[COUNT_TRICKS] - before.counts[COUNT_TRICKS],
+               5 * hands);
+  ASSERT_EQUAL(after.counts[COUNT_CARDS] - before.counts[COUNT_CARDS],
+               20 * hands);
+  ASSERT_EQUAL(after.calls[PHASE_LEAD] - before.calls[PHASE_LEAD], 5 * hands);
+  ASSERT_EQUAL(after.calls[PHASE_PLAY] - before.calls[PHASE_PLAY], 15 * hands);
+  ASSERT_EQUAL(after.counts[COUNT_BIDS] - before.counts[COUNT_BIDS],
+               after.calls[PHASE_BID] - before.calls[PHASE_BID]);
+  ASSERT_TRUE(after.ns[PHASE_GAME] - before.ns[PHASE_GAME]
+              >= after.ns[PHASE_PLAY_HAND] - before.ns[PHASE_PLAY_HAND]);
+}
+
+TEST(test_print_profile) {
+  ProfileTotals totals;
+  totals.threads = 2;
+  totals.ns[PHASE_GAME] = 5000;
+  totals.calls[PHASE_GAME] = 1;
+  totals.ns[PHASE_PLAY] = 3000;
+  totals.counts[COUNT_HANDS] = 7;
+  ostringstream out;
+  print_profile(out, totals);
+  const string text = out.str();
+  ASSERT_TRUE(text.find("profile over 2 thread(s)") != string::npos);
+  ASSERT_TRUE(text.find("play decision") != string::npos);
+  ASSERT_TRUE(text.find("hands                          7") != string::npos);
+  // Engine time is the game less the decisions
+  ASSERT_TRUE(text.find("engine                         1         0.002")
+              != string::npos);
+}
+
+TEST_MAIN()
@@ -0,0 +1,59 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+/* Random.hpp
+ *
+ * Counter-based pseudo random numbers for reproducible shuffling
+ */
+
+#include <cstdint>
+
+// Rng produces the n-th number of a stream by hashing a per-stream key with
+// the counter n (the SplitMix64 finalizer), so streams never share state and
+// any position can be reproduced from (seed, stream, counter) alone.
+class Rng {
+public:
+  //EFFECTS Initializes Rng to the start of stream `stream` of seed `seed`
+  constexpr explicit Rng(uint64_t seed, uint64_t stream = 0)
+    : key(mix(seed) ^ mix(stream + GAMMA)), counter(0) {}
+
+  //EFFECTS Returns the next 64 random bits
+  constexpr uint64_t next() {
+    return mix(key + ++counter * GAMMA);
+  }
+
+  //REQUIRES bound > 0
+  //EFFECTS Returns a uniformly distributed integer in [0, bound).  Uses
+  //  Lemire's multiply-shift with rejection, so there is no modulo bias.
+  uint32_t below(uint32_t bound) {
+    uint64_t product = uint64_t(uint32_t(next())) * bound;
+    uint32_t low = uint32_t(product);
+    if (low < bound) {
+      const uint32_t threshold = (0u - bound) % bound;
+      while (low < threshold) {
+        product = uint64_t(uint32_t(next())) * bound;
+        low = uint32_t(product);
+      }
+    }
+    return uint32_t(product >> 32);
+  }
+
+  //EFFECTS Returns how many numbers have been drawn from this stream
+  uint64_t get_counter() const { return counter; }
+
+  //EFFECTS Moves to position counter_in of the stream
+  void set_counter(uint64_t counter_in) { counter = counter_in; }
+
+private:
+  static const uint64_t GAMMA = 0x9e3779b97f4a7c15ull;
+
+  static constexpr uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t key;
+  uint64_t counter;
+};
+
+#endif // RANDOM_HPP
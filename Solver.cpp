@@ -0,0 +1,220 @@
+// Solver.cpp
+#include "Solver.hpp"
+#include "EndgameTable.hpp"
+#include "GameState.hpp"
+#include "Player.hpp"
+#include "Random.hpp"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+/////////////// Position ///////////////
+
+// Random keys for the parts of a Position, by Hand bit for cards.  Cards in
+// the trick are keyed by their place in it, which with the leader says who
+// played them.
+struct ZobristKeys {
+  uint64_t held[4][Hand::NUM_CARDS];
+  uint64_t in_trick[4][Hand::NUM_CARDS];
+  uint64_t leader[4];
+  uint64_t trump[4];
+};
+
+static constexpr ZobristKeys make_zobrist_keys() {
+  ZobristKeys keys = {};
+  Rng rng(0x5eed2b15);
+  for (int c = 0; c < Hand::NUM_CARDS; ++c) {
+    for (int seat = 0; seat < 4; ++seat) {
+      keys.held[seat][c] = rng.next();
+      keys.in_trick[seat][c] = rng.next();
+    }
+  }
+  for (int i = 0; i < 4; ++i) {
+    keys.leader[i] = rng.next();
+    keys.trump[i] = rng.next();
+  }
+  return keys;
+}
+
+static constexpr ZobristKeys ZOBRIST = make_zobrist_keys();
+
+static int bit_of(const Card &card) {
+  return __builtin_ctz(Hand::of(card).get_bits());
+}
+
+Hand Position::legal() const {
+  const Hand hand = hands[to_play()];
+  return played == 0 ? hand : legal_moves(hand, trick[0], trump);
+}
+
+int Position::play(const Card &card) {
+  const int seat = to_play();
+  hands[seat].remove(card);
+  trick[played++] = card;
+  if (played < 4) {
+    return -1;
+  }
+  int winner = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (Card_less(trick[winner], trick[i], trick[0], trump)) {
+      winner = i;
+    }
+  }
+  leader = (leader + winner) % 4;
+  played = 0;
+  return leader;
+}
+
+int Position::play(const Card &card, uint64_t &key) {
+  const int bit = bit_of(card);
+  const int old_leader = leader;
+  key ^= ZOBRIST.held[to_play()][bit] ^ ZOBRIST.in_trick[played][bit];
+  const int winner = play(card);
+  if (winner >= 0) {
+    for (int i = 0; i < 4; ++i) {
+      key ^= ZOBRIST.in_trick[i][bit_of(trick[i])];
+    }
+    key ^= ZOBRIST.leader[old_leader] ^ ZOBRIST.leader[winner];
+  }
+  return winner;
+}
+
+uint64_t Position::hash() const {
+  uint64_t key = ZOBRIST.leader[leader] ^ ZOBRIST.trump[trump];
+  for (int seat = 0; seat < 4; ++seat) {
+    for (uint32_t bits = hands[seat].get_bits(); bits; bits &= bits - 1) {
+      key ^= ZOBRIST.held[seat][__builtin_ctz(bits)];
+    }
+  }
+  for (int i = 0; i < played; ++i) {
+    key ^= ZOBRIST.in_trick[i][bit_of(trick[i])];
+  }
+  return key;
+}
+
+/////////////// DoubleDummySolver ///////////////
+
+DoubleDummySolver::DoubleDummySolver(TranspositionTable *shared,
+                                     const EndgameTable *endgames_in)
+  : own_table(shared ? nullptr : new TranspositionTable()),
+    table(shared ? shared : own_table.get()), endgames(endgames_in) {}
+
+array<int, 2> DoubleDummySolver::solve(const array<Hand, 4> &hands,
+                                       Suit trump, int leader) {
+  Position pos;
+  pos.hands = hands;
+  pos.trump = trump;
+  pos.leader = leader;
+  const int team0 = team0_tricks(pos);
+  return {{team0, hands[leader].size() - team0}};
+}
+
+int DoubleDummySolver::team0_tricks(const Position &pos) {
+  // Replay the trick in progress, so the search starts from the same place
+  GameState state;
+  state.hands = pos.hands;
+  for (int i = 0; i < pos.played; ++i) {
+    state.hands[(pos.leader + i) % 4].add(pos.trick[i]);
+  }
+  state.start_hand(pos.trump, pos.leader);
+  for (int i = 0; i < pos.played; ++i) {
+    state.make_move(pos.trick[i]);
+  }
+  return search(state, pos.hash(), -1, Player::MAX_HAND_SIZE + 1);
+}
+
+// Makes card's move in state like GameState::make_move, and updates key
+// the way Position::play does, so it stays the hash of the same Position
+static int make_move(GameState &state, const Card &card, uint64_t &key) {
+  const int bit = bit_of(card);
+  const int slot = state.cards_in_trick();
+  const int old_leader = state.leader();
+  key ^= ZOBRIST.held[state.to_play()][bit] ^ ZOBRIST.in_trick[slot][bit];
+  const int winner = state.make_move(card);
+  if (winner >= 0) {
+    const int first = state.count - 4;
+    for (int i = 0; i < 4; ++i) {
+      key ^= ZOBRIST.in_trick[i][bit_of(state.history[first + i])];
+    }
+    key ^= ZOBRIST.leader[old_leader] ^ ZOBRIST.leader[winner];
+  }
+  return winner;
+}
+
+// Returns the tricks team 0 takes from state.  The result is exact when it
+// lies strictly between alpha and beta, and otherwise only a bound on the
+// side of the window it fell (fail-soft alpha-beta).  Moves are made and
+// unmade in place, so state is as it was on return.
+int DoubleDummySolver::search(GameState &state, uint64_t key, int alpha,
+                              int beta) {
+  ++nodes;
+  if (state.cards_in_trick() != 0) {
+    return search_moves(state, key, alpha, beta);
+  }
+
+  const int remaining = state.hands[state.leader()].size();
+  if (remaining == 0) {
+    return 0;
+  }
+  if (endgames && remaining <= endgames->get_tricks()) {
+    Position pos;
+    pos.hands = state.hands;
+    pos.trump = state.trump;
+    pos.leader = state.leader();
+    return endgames->team0_tricks(pos);
+  }
+  TranspositionTable::Entry bounds = {0, remaining, remaining};
+  table->probe(key, bounds);
+  if (bounds.lower >= beta || bounds.lower == bounds.upper) {
+    return bounds.lower;
+  }
+  if (bounds.upper <= alpha) {
+    return bounds.upper;
+  }
+
+  alpha = max(alpha, bounds.lower);
+  beta = min(beta, bounds.upper);
+  const int value = search_moves(state, key, alpha, beta);
+  if (value <= alpha) {
+    bounds.upper = min(bounds.upper, value);
+  } else if (value >= beta) {
+    bounds.lower = max(bounds.lower, value);
+  } else {
+    bounds.lower = bounds.upper = value;
+  }
+  table->store(key, bounds);
+  return value;
+}
+
+// Tries each legal card, strongest first by Card_less, so that winning
+// cards raise or lower the window early
+int DoubleDummySolver::search_moves(GameState &state, uint64_t key,
+                                    int alpha, int beta) {
+  array<Card, Player::MAX_HAND_SIZE> moves;
+  int num_moves = 0;
+  for (Hand rest = state.legal(); !rest.empty(); rest.remove(rest.first())) {
+    moves[num_moves++] = rest.first();
+  }
+  const Suit trump = state.trump;
+  sort(moves.begin(), moves.begin() + num_moves,
+       [trump](const Card &a, const Card &b) { return Card_less(b, a, trump); });
+
+  const bool maximize = state.to_play() % 2 == 0;
+  int best = maximize ? -1 : Player::MAX_HAND_SIZE + 1;
+  for (int i = 0; i < num_moves && alpha < beta; ++i) {
+    uint64_t child_key = key;
+    const int winner = make_move(state, moves[i], child_key);
+    const int won = (winner >= 0 && winner % 2 == 0) ? 1 : 0;
+    const int value = won + search(state, child_key, alpha - won, beta - won);
+    state.unmake_move();
+    if (maximize) {
+      best = max(best, value);
+      alpha = max(alpha, best);
+    } else {
+      best = min(best, value);
+      beta = min(beta, best);
+    }
+  }
+  return best;
+}
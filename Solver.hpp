@@ -0,0 +1,88 @@
+#ifndef SOLVER_HPP
+#define SOLVER_HPP
+/* Solver.hpp
+ *
+ * Double-dummy analysis: exact trick counts when every hand is known
+ */
+
+#include "Card.hpp"
+#include "Hand.hpp"
+#include "TranspositionTable.hpp"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+// A hand in progress, with every seat's cards visible
+struct Position {
+  std::array<Hand, 4> hands; // cards each seat still holds
+  Suit trump;
+  int leader;                // seat that leads the current trick
+  int played = 0;            // cards already played to the current trick
+  std::array<Card, 4> trick; // trick[i] was played by seat (leader + i) % 4
+
+  //EFFECTS Returns the seat whose turn it is
+  int to_play() const { return (leader + played) % 4; }
+
+  //EFFECTS Returns the cards the seat to play may legally play
+  Hand legal() const;
+
+  //REQUIRES card is in legal()
+  //MODIFIES this Position
+  //EFFECTS Plays card for the seat to play.  If that completes the trick,
+  //  starts the next one with the winner leading and returns the winner;
+  //  otherwise returns -1.
+  int play(const Card &card);
+
+  //REQUIRES key is hash() and card is in legal()
+  //MODIFIES this Position, key
+  //EFFECTS Plays card like play(), and updates key to the new hash()
+  //  without rehashing the whole Position
+  int play(const Card &card, uint64_t &key);
+
+  //EFFECTS Returns the Zobrist hash of this Position: the XOR of a fixed
+  //  random key for each card held by each seat, each card in the trick
+  //  with its place in the trick, the leader and trump.  Positions with
+  //  equal hashes are the same position barring a 64-bit collision,
+  //  whatever deal they came from, mid-trick or not.
+  uint64_t hash() const;
+};
+
+class EndgameTable;
+struct GameState;
+
+class DoubleDummySolver {
+public:
+  //EFFECTS Makes a solver with a table of its own, or one that shares
+  //  table with other solvers, which may run on other threads.  With
+  //  endgames, positions it covers are looked up instead of searched.
+  explicit DoubleDummySolver(TranspositionTable *shared = nullptr,
+                             const EndgameTable *endgames = nullptr);
+
+  //REQUIRES every hand holds the same number of cards, at most 5, and no
+  //  card is held twice
+  //EFFECTS Returns the tricks each team takes when all four seats play
+  //  perfectly, seeing every hand.  leader leads the first trick.
+  std::array<int, 2> solve(const std::array<Hand, 4> &hands, Suit trump,
+                           int leader);
+
+  //REQUIRES pos is reachable by legal play from equal-sized hands
+  //EFFECTS Returns the tricks team 0 takes from pos to the end of the hand,
+  //  counting the trick in progress, with perfect play from every seat
+  int team0_tricks(const Position &pos);
+
+  //EFFECTS Returns the number of positions searched since construction
+  long get_nodes() const { return nodes; }
+
+private:
+  // Bounds on the tricks team 0 takes from positions at trick boundaries,
+  // with the tricks left as the depth
+  std::unique_ptr<TranspositionTable> own_table;
+  TranspositionTable *table;
+  const EndgameTable *endgames;
+  long nodes = 0;
+
+  int search(GameState &state, uint64_t key, int alpha, int beta);
+  int search_moves(GameState &state, uint64_t key, int alpha, int beta);
+};
+
+#endif // SOLVER_HPP
@@ -0,0 +1,205 @@
+#include "Solver.hpp"
+#include "Pack.hpp"
+#include "unit_test_framework.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Plain minimax over every legal card, no pruning and no table
+static int brute_force(const Position &pos) {
+  if (pos.played == 0 && pos.hands[pos.leader].empty()) {
+    return 0;
+  }
+  const bool maximize = pos.to_play() % 2 == 0;
+  int best = maximize ? -1 : 6;
+  for (Hand rest = pos.legal(); !rest.empty(); rest.remove(rest.first())) {
+    Position child = pos;
+    const int winner = child.play(rest.first());
+    const int value = (winner >= 0 && winner % 2 == 0) + brute_force(child);
+    best = maximize ? max(best, value) : min(best, value);
+  }
+  return best;
+}
+
+// Deals cards_each cards to every seat from a random shuffle
+static array<Hand, 4> random_deal(Rng &rng, int cards_each) {
+  Pack pack;
+  pack.shuffle(rng);
+  array<Hand, 4> hands;
+  for (int seat = 0; seat < 4; ++seat) {
+    for (int c = 0; c < cards_each; ++c) {
+      hands[seat].add(pack.deal_one());
+    }
+  }
+  return hands;
+}
+
+TEST(test_solver_one_card) {
+  array<Hand, 4> hands = {{Hand::of(Card(NINE, SPADES)),
+                           Hand::of(Card(ACE, SPADES)),
+                           Hand::of(Card(NINE, HEARTS)),
+                           Hand::of(Card(TEN, SPADES))}};
+  DoubleDummySolver solver;
+  array<int, 2> tricks = solver.solve(hands, HEARTS, 0);
+  ASSERT_EQUAL(tricks[0], 1); // partner trumps the Ace
+  ASSERT_EQUAL(tricks[1], 0);
+  tricks = solver.solve(hands, DIAMONDS, 0);
+  ASSERT_EQUAL(tricks[0], 0);
+  ASSERT_EQUAL(tricks[1], 1);
+}
+
+TEST(test_solver_left_bower_must_follow_trump) {
+  // Seat 1 holds the left bower and must play it on a trump lead
+  array<Hand, 4> hands = {{Hand::of(Card(NINE, SPADES)),
+                           Hand::of(Card(JACK, CLUBS)) | Hand::of(Card(ACE, CLUBS)),
+                           Hand::of(Card(NINE, HEARTS)),
+                           Hand::of(Card(TEN, HEARTS))}};
+  hands[0].add(Card(KING, CLUBS));
+  hands[2].add(Card(TEN, CLUBS));
+  hands[3].add(Card(QUEEN, CLUBS));
+  DoubleDummySolver solver;
+  Position pos;
+  pos.hands = hands;
+  pos.trump = SPADES;
+  pos.leader = 0;
+  ASSERT_EQUAL(solver.team0_tricks(pos), brute_force(pos));
+}
+
+TEST(test_solver_matches_brute_force) {
+  Rng rng(2024);
+  DoubleDummySolver solver;
+  for (int deal = 0; deal < 40; ++deal) {
+    Position pos;
+    pos.hands = random_deal(rng, 3);
+    pos.trump = static_cast<Suit>(deal % 4);
+    pos.leader = deal % 4;
+    ASSERT_EQUAL(solver.team0_tricks(pos), brute_force(pos));
+
+    // Same deal part way through a trick
+    pos.play(pos.legal().last());
+    pos.play(pos.legal().first());
+    ASSERT_EQUAL(solver.team0_tricks(pos), brute_force(pos));
+  }
+}
+
+TEST(test_solver_full_hands) {
+  Rng rng(7);
+  DoubleDummySolver solver;
+  for (int deal = 0; deal < 2; ++deal) {
+    Position pos;
+    pos.hands = random_deal(rng, 5);
+    pos.trump = static_cast<Suit>(deal);
+    pos.leader = 3 - deal;
+    const array<int, 2> tricks = solver.solve(pos.hands, pos.trump, pos.leader);
+    ASSERT_EQUAL(tricks[0], brute_force(pos));
+    ASSERT_EQUAL(tricks[0] + tricks[1], 5);
+  }
+}
+
+TEST(test_position_incremental_hash) {
+  Rng rng(11);
+  for (int deal = 0; deal < 20; ++deal) {
+    Position pos;
+    pos.hands = random_deal(rng, 5);
+    pos.trump = static_cast<Suit>(deal % 4);
+    pos.leader = deal % 4;
+    uint64_t key = pos.hash();
+    while (!pos.hands[pos.to_play()].empty()) {
+      const Hand legal = pos.legal();
+      pos.play(deal % 2 ? legal.first() : legal.last(), key);
+      ASSERT_EQUAL(key, pos.hash());
+    }
+  }
+}
+
+TEST(test_position_hash_distinguishes_owner_and_leader) {
+  Position pos;
+  pos.hands = {{Hand::of(Card(NINE, SPADES)), Hand::of(Card(TEN, SPADES)),
+                Hand::of(Card(JACK, HEARTS)), Hand::of(Card(ACE, CLUBS))}};
+  pos.trump = HEARTS;
+  pos.leader = 0;
+  Position swapped = pos;
+  swap(swapped.hands[0], swapped.hands[1]);
+  Position led = pos;
+  led.leader = 1;
+  ASSERT_NOT_EQUAL(pos.hash(), swapped.hash());
+  ASSERT_NOT_EQUAL(pos.hash(), led.hash());
+}
+
+TEST(test_position_hash_distinguishes_who_played_in_trick) {
+  // The same cards held and in the trick, but played by different seats
+  Position pos;
+  pos.hands = {{Hand(), Hand(), Hand::of(Card(JACK, HEARTS)),
+                Hand::of(Card(ACE, CLUBS))}};
+  pos.trump = HEARTS;
+  pos.leader = 0;
+  pos.played = 2;
+  pos.trick[0] = Card(NINE, SPADES);
+  pos.trick[1] = Card(TEN, SPADES);
+  Position swapped = pos;
+  swap(swapped.trick[0], swapped.trick[1]);
+  ASSERT_NOT_EQUAL(pos.hash(), swapped.hash());
+}
+
+TEST(test_table_store_probe_replace) {
+  TranspositionTable table(0); // one bucket
+  TranspositionTable::Entry entry = {};
+  ASSERT_FALSE(table.probe(1, entry));
+
+  // Fill the bucket, then overwrite key 1 in place
+  for (int key = 1; key <= TranspositionTable::SLOTS; ++key) {
+    table.store(key, {0, 1, key});
+  }
+  table.store(1, {2, 2, 2});
+  ASSERT_TRUE(table.probe(1, entry));
+  ASSERT_EQUAL(entry.lower, 2);
+  ASSERT_EQUAL(entry.upper, 2);
+
+  // A new key evicts the shallowest entry, and of those one holding only a
+  // bound: keys 1 and 2 are shallowest, and only key 1 is exact
+  table.store(100, {0, 3, 1});
+  ASSERT_TRUE(table.probe(100, entry));
+  ASSERT_FALSE(table.probe(2, entry));
+  ASSERT_TRUE(table.probe(1, entry));
+
+  table.clear();
+  ASSERT_FALSE(table.probe(1, entry));
+}
+
+TEST(test_solver_shared_table_across_threads) {
+  Rng rng(5);
+  vector<Position> deals(32);
+  vector<int> expected(deals.size());
+  for (size_t i = 0; i < deals.size(); ++i) {
+    deals[i].hands = random_deal(rng, 4);
+    deals[i].trump = static_cast<Suit>(i % 4);
+    deals[i].leader = i % 4;
+    expected[i] = DoubleDummySolver().team0_tricks(deals[i]);
+  }
+
+  // Every thread solves every deal, starting at different ones
+  TranspositionTable table(4);
+  const int num_threads = 4;
+  vector<vector<int>> found(num_threads, vector<int>(deals.size()));
+  vector<thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      DoubleDummySolver solver(&table);
+      for (size_t i = 0; i < deals.size(); ++i) {
+        const size_t d = (i + t * 8) % deals.size();
+        found[t][d] = solver.team0_tricks(deals[d]);
+      }
+    });
+  }
+  for (thread &th : threads) {
+    th.join();
+  }
+  for (const vector<int> &f : found) {
+    ASSERT_TRUE(f == expected);
+  }
+}
+
+TEST_MAIN()
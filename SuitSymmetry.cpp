@@ -0,0 +1,84 @@
+// SuitSymmetry.cpp
+#include "SuitSymmetry.hpp"
+#include <cassert>
+
+using namespace std;
+
+// Bit of card in a Hand
+static uint32_t bit_of(const Card &card) {
+  return __builtin_ctz(Hand::of(card).get_bits());
+}
+
+CanonicalBid canonicalize(Hand hand, const Card &upcard) {
+  assert(!hand.contains(upcard));
+  CanonicalBid best = {};
+  for (int n = 0; n < SuitPermutation::COUNT; ++n) {
+    const SuitPermutation p = SuitPermutation::nth(n);
+    const Card up = p(upcard);
+    const Hand relabeled = p(hand);
+    const uint32_t key = bit_of(up) << Hand::NUM_CARDS | relabeled.get_bits();
+    if (n == 0 || key < best.key) {
+      best = {key, relabeled, up, p.inverse()};
+    }
+  }
+  return best;
+}
+
+CanonicalHand canonicalize(Hand hand, Suit trump) {
+  CanonicalHand best = {};
+  for (int n = 0; n < SuitPermutation::COUNT; ++n) {
+    const SuitPermutation p = SuitPermutation::nth(n);
+    const Hand relabeled = p(hand);
+    const uint32_t key =
+        uint32_t(p(trump)) << Hand::NUM_CARDS | relabeled.get_bits();
+    if (n == 0 || key < best.key) {
+      best = {key, relabeled, p(trump), p.inverse()};
+    }
+  }
+  return best;
+}
+
+// True if a sorts before b: by trump, then by each seat's cards in turn
+static bool deal_less(const array<Hand, 4> &a, Suit a_trump,
+                      const array<Hand, 4> &b, Suit b_trump) {
+  if (a_trump != b_trump) {
+    return a_trump < b_trump;
+  }
+  for (int seat = 0; seat < 4; ++seat) {
+    if (a[seat] != b[seat]) {
+      return a[seat].get_bits() < b[seat].get_bits();
+    }
+  }
+  return false;
+}
+
+CanonicalDeal canonicalize(const array<Hand, 4> &hands, Suit trump) {
+  CanonicalDeal best = {};
+  for (int n = 0; n < SuitPermutation::COUNT; ++n) {
+    const SuitPermutation p = SuitPermutation::nth(n);
+    array<Hand, 4> relabeled;
+    for (int seat = 0; seat < 4; ++seat) {
+      relabeled[seat] = p(hands[seat]);
+    }
+    if (n == 0 || deal_less(relabeled, p(trump), best.hands, best.trump)) {
+      best = {relabeled, p(trump), p.inverse()};
+    }
+  }
+  return best;
+}
+
+uint64_t CanonicalDeal::key() const {
+  array<unsigned char, Hand::NUM_CARDS> holder;
+  holder.fill(4);
+  for (int seat = 0; seat < 4; ++seat) {
+    for (uint32_t bits = hands[seat].get_bits(); bits; bits &= bits - 1) {
+      assert(holder[__builtin_ctz(bits)] == 4);
+      holder[__builtin_ctz(bits)] = static_cast<unsigned char>(seat);
+    }
+  }
+  uint64_t key = 0;
+  for (int bit = Hand::NUM_CARDS - 1; bit >= 0; --bit) {
+    key = key * 5 + holder[bit];
+  }
+  return key;
+}
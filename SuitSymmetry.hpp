@@ -0,0 +1,107 @@
+#ifndef SUIT_SYMMETRY_HPP
+#define SUIT_SYMMETRY_HPP
+/* SuitSymmetry.hpp
+ *
+ * Euchre treats the suits alike except that each is paired with the other
+ * suit of its color, Suit_next, for the left bower.  Relabeling the suits
+ * so the pairs stay pairs turns any hand or deal into an equivalent one:
+ * trick winners, legal plays and so double-dummy values are unchanged.
+ * There are eight such relabelings, so tables keyed by a canonical form
+ * need up to eight times fewer entries.
+ *
+ * The Simple strategy breaks ties between equal ranks by suit, so results
+ * that depend on it are symmetric only up to those ties.
+ */
+
+#include "Card.hpp"
+#include "Hand.hpp"
+#include <array>
+#include <cstdint>
+
+class SuitPermutation {
+public:
+  static const int COUNT = 8;
+
+  //EFFECTS Initializes the identity
+  constexpr SuitPermutation() : map{{SPADES, HEARTS, CLUBS, DIAMONDS}} {}
+
+  //REQUIRES 0 <= n < COUNT
+  //EFFECTS Returns relabeling n.  n / 2 picks the image of Spades, whose
+  //  partner Clubs goes to its Suit_next, and n % 2 picks which suit of
+  //  the other pair Hearts goes to.
+  static constexpr SuitPermutation nth(int n) {
+    SuitPermutation p;
+    const Suit spades = static_cast<Suit>(n / 2);
+    const Suit other = static_cast<Suit>(spades ^ 1);
+    const Suit hearts = n % 2 ? Suit_next(other) : other;
+    p.map = {{spades, hearts, Suit_next(spades), Suit_next(hearts)}};
+    return p;
+  }
+
+  constexpr Suit operator()(Suit suit) const { return map[suit]; }
+
+  constexpr Card operator()(const Card &c) const {
+    return Card(c.get_rank(), map[c.get_suit()]);
+  }
+
+  constexpr Hand operator()(Hand hand) const { return hand.with_suits(map); }
+
+  //EFFECTS Returns the relabeling that undoes this one
+  constexpr SuitPermutation inverse() const {
+    SuitPermutation p;
+    for (int s = SPADES; s <= DIAMONDS; ++s) {
+      p.map[map[s]] = static_cast<Suit>(s);
+    }
+    return p;
+  }
+
+  friend bool operator==(const SuitPermutation &lhs,
+                         const SuitPermutation &rhs) {
+    return lhs.map == rhs.map;
+  }
+
+private:
+  std::array<Suit, 4> map; // map[s] is the new label of suit s
+};
+
+// A hand and upcard relabeled to the least key of their eight relabelings
+struct CanonicalBid {
+  uint32_t key;                 // hand bits, with the upcard's bit above them
+  Hand hand;
+  Card upcard;                  // always a Spade
+  SuitPermutation to_original;  // maps hand and upcard back
+};
+
+//REQUIRES hand does not hold upcard
+//EFFECTS Returns the canonical form of hand with upcard turned up
+CanonicalBid canonicalize(Hand hand, const Card &upcard);
+
+// A hand relabeled, with trump, to the least of its eight relabelings
+struct CanonicalHand {
+  uint32_t key;                 // hand bits, with trump above them
+  Hand hand;
+  Suit trump;                   // always Spades
+  SuitPermutation to_original;
+};
+
+//EFFECTS Returns the canonical form of hand when trump is trump
+CanonicalHand canonicalize(Hand hand, Suit trump);
+
+// A deal relabeled to the least of its eight relabelings, comparing trump
+// and then the hands in seat order
+struct CanonicalDeal {
+  std::array<Hand, 4> hands;
+  Suit trump;                   // always Spades
+  SuitPermutation to_original;
+
+  //REQUIRES no card is in two hands
+  //EFFECTS Returns the deal as a number: each card's holder, or 4 if no
+  //  seat holds it, as one base-5 digit.  Deals share a key exactly when
+  //  they relabel to one another.
+  uint64_t key() const;
+};
+
+//EFFECTS Returns the canonical form of a deal with trump trump
+CanonicalDeal canonicalize(const std::array<Hand, 4> &hands, Suit trump);
+
+#endif // SUIT_SYMMETRY_HPP
@@ -0,0 +1,138 @@
+#include "SuitSymmetry.hpp"
+#include "Pack.hpp"
+#include "Solver.hpp"
+#include "unit_test_framework.hpp"
+
+#include <set>
+
+using namespace std;
+
+// Deals cards_each cards to every seat from a random shuffle
+static array<Hand, 4> random_deal(Rng &rng, int cards_each) {
+  Pack pack;
+  pack.shuffle(rng);
+  array<Hand, 4> hands;
+  for (int seat = 0; seat < 4; ++seat) {
+    for (int c = 0; c < cards_each; ++c) {
+      hands[seat].add(pack.deal_one());
+    }
+  }
+  return hands;
+}
+
+TEST(test_permutations_keep_colors) {
+  set<vector<int>> seen;
+  for (int n = 0; n < SuitPermutation::COUNT; ++n) {
+    const SuitPermutation p = SuitPermutation::nth(n);
+    vector<int> images;
+    for (int s = SPADES; s <= DIAMONDS; ++s) {
+      const Suit suit = static_cast<Suit>(s);
+      ASSERT_EQUAL(p(Suit_next(suit)), Suit_next(p(suit)));
+      ASSERT_EQUAL(p.inverse()(p(suit)), suit);
+      images.push_back(p(suit));
+    }
+    seen.insert(images);
+  }
+  ASSERT_EQUAL(seen.size(), size_t(SuitPermutation::COUNT));
+  ASSERT_TRUE(SuitPermutation::nth(0) == SuitPermutation());
+}
+
+TEST(test_permutation_relabels_hands_card_by_card) {
+  Rng rng(3);
+  const Hand hand = random_deal(rng, 5)[0] | random_deal(rng, 5)[1];
+  for (int n = 0; n < SuitPermutation::COUNT; ++n) {
+    const SuitPermutation p = SuitPermutation::nth(n);
+    Hand expected;
+    for (Hand rest = hand; !rest.empty(); rest.remove(rest.first())) {
+      expected.add(p(rest.first()));
+    }
+    ASSERT_TRUE(p(hand) == expected);
+    ASSERT_TRUE(p.inverse()(p(hand)) == hand);
+  }
+}
+
+TEST(test_canonical_bid_is_shared_by_relabelings) {
+  Rng rng(11);
+  for (int trial = 0; trial < 50; ++trial) {
+    const array<Hand, 4> deal = random_deal(rng, 5);
+    const Hand hand = deal[0];
+    const Card upcard = deal[1].first();
+    const CanonicalBid bid = canonicalize(hand, upcard);
+    ASSERT_EQUAL(bid.upcard.get_suit(), SPADES);
+    ASSERT_TRUE(bid.to_original(bid.hand) == hand);
+    ASSERT_EQUAL(bid.to_original(bid.upcard), upcard);
+    for (int n = 0; n < SuitPermutation::COUNT; ++n) {
+      const SuitPermutation p = SuitPermutation::nth(n);
+      const CanonicalBid other = canonicalize(p(hand), p(upcard));
+      ASSERT_EQUAL(other.key, bid.key);
+      ASSERT_TRUE(other.hand == bid.hand);
+    }
+  }
+}
+
+TEST(test_canonical_hand_puts_trump_in_spades) {
+  Rng rng(12);
+  const Hand hand = random_deal(rng, 5)[2];
+  for (int s = SPADES; s <= DIAMONDS; ++s) {
+    const CanonicalHand canon = canonicalize(hand, static_cast<Suit>(s));
+    ASSERT_EQUAL(canon.trump, SPADES);
+    ASSERT_EQUAL(canon.to_original(canon.trump), static_cast<Suit>(s));
+    ASSERT_TRUE(canon.to_original(canon.hand) == hand);
+  }
+}
+
+TEST(test_canonical_deal_keeps_solver_value) {
+  Rng rng(13);
+  DoubleDummySolver solver;
+  for (int trial = 0; trial < 20; ++trial) {
+    const array<Hand, 4> hands = random_deal(rng, 3);
+    const Suit trump = static_cast<Suit>(trial % 4);
+    const CanonicalDeal deal = canonicalize(hands, trump);
+    ASSERT_EQUAL(deal.trump, SPADES);
+    for (int seat = 0; seat < 4; ++seat) {
+      ASSERT_TRUE(deal.to_original(deal.hands[seat]) == hands[seat]);
+    }
+    ASSERT_EQUAL(solver.solve(deal.hands, deal.trump, trial % 4)[0],
+                 solver.solve(hands, trump, trial % 4)[0]);
+
+    for (int n = 0; n < SuitPermutation::COUNT; ++n) {
+      const SuitPermutation p = SuitPermutation::nth(n);
+      array<Hand, 4> relabeled;
+      for (int seat = 0; seat < 4; ++seat) {
+        relabeled[seat] = p(hands[seat]);
+      }
+      ASSERT_EQUAL(canonicalize(relabeled, p(trump)).key(), deal.key());
+    }
+  }
+}
+
+TEST(test_canonical_deal_keys_differ_between_deals) {
+  Rng rng(14);
+  const array<Hand, 4> hands = random_deal(rng, 5);
+  array<Hand, 4> swapped = hands;
+  swap(swapped[0], swapped[1]);
+  ASSERT_NOT_EQUAL(canonicalize(hands, HEARTS).key(),
+                   canonicalize(swapped, HEARTS).key());
+}
+
+TEST(test_bid_classes_shrink_by_about_eight) {
+  long total = 0;
+  set<uint32_t> classes;
+  // Every five-card hand, in order of bits by Gosper's hack
+  for (uint32_t bits = 0x1F; bits < (1u << Hand::NUM_CARDS);) {
+    const Hand hand(bits);
+    for (Hand ups = Hand::full().without(hand); !ups.empty();
+         ups.remove(ups.first())) {
+      ++total;
+      classes.insert(canonicalize(hand, ups.first()).key);
+    }
+    const uint32_t low = bits & -bits;
+    const uint32_t ripple = bits + low;
+    bits = ripple | (((bits ^ ripple) >> 2) / low);
+  }
+  ASSERT_EQUAL(total, 42504L * 19);
+  ASSERT_TRUE(classes.size() * 8 >= size_t(total));
+  ASSERT_TRUE(classes.size() * 7 < size_t(total));
+}
+
+TEST_MAIN()
@@ -0,0 +1,352 @@
+// TableScheduler.cpp
+#include "TableScheduler.hpp"
+#include <cassert>
+#include <cstdint>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Where a table or the scheduler left off.  swapcontext saves the signal
+// mask too, which costs a system call on every switch, but it is the
+// switch POSIX documents for moving between stacks made by makecontext.
+struct TableScheduler::Context {
+  ucontext_t uc;
+};
+
+struct TableScheduler::Table {
+  enum State { READY, RUNNING, SUSPENDED, FINISHED };
+
+  TableScheduler *scheduler;
+  int id;
+  function<void()> body;
+  Context context;
+  bool started = false;
+  void *stack = nullptr;  // with a guard page below it
+  size_t mapping_size = 0;
+
+  // Guarded by the scheduler's lock
+  State state = READY;
+  bool woken = false;  // resumed while running, so suspend returns at once
+
+  ~Table() {
+    if (stack) {
+      munmap(static_cast<char *>(stack) - guard_size(), mapping_size);
+    }
+  }
+
+  static size_t guard_size() {
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  }
+};
+
+TableScheduler::TableScheduler(size_t stack_size_in)
+  : scheduler_context(new Context) {
+  // Round up to whole pages, so the guard page stays aligned
+  const size_t page = Table::guard_size();
+  stack_size = (stack_size_in + page - 1) / page * page;
+}
+
+TableScheduler::~TableScheduler() {
+  assert(current == -1);
+  // Unwind every table left waiting, so its game and players are destroyed
+  // before its stack is unmapped.  Tables that never started only hold
+  // their body, which goes with them.
+  cancelling = true;
+  for (const unique_ptr<Table> &table : tables) {
+    if (table->started && table->state != Table::FINISHED) {
+      {
+        lock_guard<mutex> guard(lock);
+        table->state = Table::RUNNING;
+      }
+      switch_to(*table);
+      assert(table->state == Table::FINISHED);
+    }
+  }
+}
+
+int TableScheduler::add_table(function<void()> body) {
+  assert(current == -1);
+  Table *table;
+  if (!spare.empty()) {
+    // A finished table's stack is as good as new
+    table = tables[spare.back()].get();
+    spare.pop_back();
+    table->started = false;
+    table->woken = false;
+  } else {
+    table = new Table;
+    table->scheduler = this;
+    table->id = static_cast<int>(tables.size());
+    tables.emplace_back(table);
+
+    // The stack grows down into the guard page, which faults on overflow
+    // instead of overwriting whatever lies below
+    const size_t guard = Table::guard_size();
+    table->mapping_size = stack_size + guard;
+    void *base = mmap(nullptr, table->mapping_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
+      tables.pop_back();
+      throw bad_alloc();
+    }
+    mprotect(base, guard, PROT_NONE);
+    table->stack = static_cast<char *>(base) + guard;
+  }
+  table->body = move(body);
+
+  // When start returns, the table switches back to the scheduler for good
+  ucontext_t &uc = table->context.uc;
+  getcontext(&uc);
+  uc.uc_stack.ss_sp = table->stack;
+  uc.uc_stack.ss_size = stack_size;
+  uc.uc_link = &scheduler_context->uc;
+  // makecontext only passes ints, so the Table's address goes in two
+  const uintptr_t address = reinterpret_cast<uintptr_t>(table);
+  makecontext(&uc, reinterpret_cast<void (*)()>(&start), 2,
+              static_cast<unsigned>(address),
+              static_cast<unsigned>(static_cast<uint64_t>(address) >> 32));
+
+  ++unfinished;
+  lock_guard<mutex> guard(lock);
+  table->state = Table::READY;
+  ready.push_back(table->id);
+  return table->id;
+}
+
+void TableScheduler::start(unsigned low, unsigned high) {
+  Table *table = reinterpret_cast<Table *>(
+      static_cast<uintptr_t>((static_cast<uint64_t>(high) << 32) | low));
+  try {
+    table->body();
+  } catch (const Cancelled &) {
+    // The scheduler is going away; the stack is unwound, which is all
+    // cancelling asks
+  }
+  table->body = nullptr;
+  lock_guard<mutex> guard(table->scheduler->lock);
+  table->state = Table::FINISHED;
+}
+
+void TableScheduler::switch_to(Table &table) {
+  current = table.id;
+  table.started = true;
+  swapcontext(&scheduler_context->uc, &table.context.uc);
+  current = -1;
+}
+
+void TableScheduler::suspend() {
+  assert(current != -1);
+  if (cancelling) {
+    throw Cancelled();
+  }
+  Table &table = *tables[current];
+  {
+    lock_guard<mutex> guard(lock);
+    if (table.woken) {
+      table.woken = false;
+      return;
+    }
+    table.state = Table::SUSPENDED;
+  }
+  // A resume() from another thread may queue the table before it has
+  // switched out, but only this thread runs tables, so it cannot start
+  // running again until then
+  swapcontext(&table.context.uc, &scheduler_context->uc);
+  if (cancelling) {
+    throw Cancelled();
+  }
+}
+
+void TableScheduler::resume(int table) {
+  lock_guard<mutex> guard(lock);
+  Table &t = *tables[table];
+  if (t.state == Table::SUSPENDED) {
+    t.state = Table::READY;
+    ready.push_back(table);
+    wake.notify_one();
+  } else if (t.state == Table::RUNNING) {
+    t.woken = true;
+  }
+}
+
+size_t TableScheduler::run_ready() {
+  assert(current == -1);
+  while (true) {
+    Table *table;
+    {
+      lock_guard<mutex> guard(lock);
+      if (ready.empty()) {
+        break;
+      }
+      table = tables[ready.front()].get();
+      ready.pop_front();
+      table->state = Table::RUNNING;
+    }
+    switch_to(*table);
+
+    lock_guard<mutex> guard(lock);
+    if (table->state == Table::FINISHED) {
+      spare.push_back(table->id);
+      --unfinished;
+    }
+  }
+  return unfinished;
+}
+
+void TableScheduler::run() {
+  while (run_ready() > 0) {
+    unique_lock<mutex> guard(lock);
+    wake.wait(guard, [this] { return !ready.empty(); });
+  }
+}
+
+static bool is_euchre_card(const Card &card) {
+  return card.get_rank() >= NINE;
+}
+
+bool is_legal_answer(const DecisionRequest &request,
+                     const DecisionAnswer &answer) {
+  switch (request.decision) {
+  case DECISION_MAKE_TRUMP:
+    if (!answer.order_up) {
+      // The dealer is stuck with the last chance to order up
+      return !(request.is_dealer && request.round == 2);
+    }
+    if (answer.suit < SPADES || answer.suit > DIAMONDS) {
+      return false;
+    }
+    return (answer.suit == request.upcard.get_suit()) == (request.round == 1);
+  case DECISION_ADD_AND_DISCARD:
+    return is_euchre_card(answer.card)
+      && (request.hand | Hand::of(request.upcard)).contains(answer.card);
+  case DECISION_LEAD_CARD:
+    return is_euchre_card(answer.card) && request.hand.contains(answer.card);
+  case DECISION_PLAY_CARD:
+    return is_euchre_card(answer.card)
+      && legal_moves(request.hand, request.led, request.trump)
+           .contains(answer.card);
+  default:
+    return false;
+  }
+}
+
+DecisionAnswer simple_answer(const DecisionRequest &request) {
+  DecisionAnswer answer;
+  switch (request.decision) {
+  case DECISION_MAKE_TRUMP:
+    answer.order_up = simple_make_trump(request.hand, request.upcard,
+                                        request.is_dealer, request.round,
+                                        answer.suit);
+    break;
+  case DECISION_ADD_AND_DISCARD:
+    answer.card = simple_discard(request.hand | Hand::of(request.upcard),
+                                 request.upcard);
+    break;
+  case DECISION_LEAD_CARD:
+    answer.card = simple_lead(request.hand, request.trump);
+    break;
+  default:
+    answer.card = simple_play(request.hand, request.led, request.trump);
+    break;
+  }
+  return answer;
+}
+
+AsyncSeat::AsyncSeat(const string &name_in, TableScheduler &scheduler_in,
+                     RequestHandler on_request_in)
+  : name(name_in), scheduler(scheduler_in),
+    on_request(move(on_request_in)) {}
+
+void AsyncSeat::add_card(const Card &c) {
+  hand.add(c);
+}
+
+void AsyncSeat::observe_deal(int seat_in, int, const Card &) {
+  seat = seat_in;
+}
+
+bool AsyncSeat::make_trump(const Card &upcard, bool is_dealer, int round,
+                           Suit &order_up_suit) const {
+  DecisionRequest request_out;
+  request_out.decision = DECISION_MAKE_TRUMP;
+  request_out.upcard = upcard;
+  request_out.is_dealer = is_dealer;
+  request_out.round = round;
+  const DecisionAnswer made = ask(request_out);
+  if (made.order_up) {
+    order_up_suit = made.suit;
+  }
+  return made.order_up;
+}
+
+Card AsyncSeat::add_and_discard(const Card &upcard) {
+  DecisionRequest request_out;
+  request_out.decision = DECISION_ADD_AND_DISCARD;
+  request_out.upcard = upcard;
+  const Card discard = ask(request_out).card;
+  hand.add(upcard);
+  hand.remove(discard);
+  return discard;
+}
+
+Card AsyncSeat::lead_card(Suit trump) {
+  DecisionRequest request_out;
+  request_out.decision = DECISION_LEAD_CARD;
+  request_out.trump = trump;
+  const Card led = ask(request_out).card;
+  hand.remove(led);
+  return led;
+}
+
+Card AsyncSeat::play_card(const Card &led_card, Suit trump) {
+  DecisionRequest request_out;
+  request_out.decision = DECISION_PLAY_CARD;
+  request_out.led = led_card;
+  request_out.trump = trump;
+  const Card played = ask(request_out).card;
+  hand.remove(played);
+  return played;
+}
+
+DecisionAnswer AsyncSeat::ask(const DecisionRequest &request_in) const {
+  DecisionRequest published = request_in;
+  published.table = scheduler.current_table();
+  published.seat = seat;
+  published.hand = hand;
+  {
+    lock_guard<mutex> guard(lock);
+    assert(!waiting);
+    request = published;
+    waiting = true;
+  }
+  // make_trump is const, but the seat itself is not
+  on_request(const_cast<AsyncSeat &>(*this), published);
+
+  // Other seats' answers may resume the table too, so check each time
+  while (true) {
+    {
+      lock_guard<mutex> guard(lock);
+      if (!waiting) {
+        return reply;
+      }
+    }
+    scheduler.suspend();
+  }
+}
+
+bool AsyncSeat::answer(const DecisionAnswer &answer_in) {
+  int table;
+  {
+    lock_guard<mutex> guard(lock);
+    if (!waiting || !is_legal_answer(request, answer_in)) {
+      return false;
+    }
+    reply = answer_in;
+    waiting = false;
+    table = request.table;
+  }
+  scheduler.resume(table);
+  return true;
+}
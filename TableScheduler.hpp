@@ -0,0 +1,183 @@
+#ifndef TABLE_SCHEDULER_HPP
+#define TABLE_SCHEDULER_HPP
+/* TableScheduler.hpp
+ *
+ * Runs many games on one thread as coroutines, so a seat can wait for a
+ * slow human or networked player without holding a thread
+ */
+
+#include "Card.hpp"
+#include "Hand.hpp"
+#include "Player.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Each table is a coroutine with a stack of its own, so its body, usually
+// Game::play, runs unchanged and may suspend from any depth: an AsyncSeat
+// suspends its table at every decision until the answer arrives.  Tables
+// only run on the thread calling run() or run_ready(); resume() may be
+// called from any thread.
+//
+// Tables switch with swapcontext, which saves and restores the signal mask
+// with a system call each way: a suspend and resume costs about 0.7 us,
+// where a game makes some 270 decisions.  A game whose every decision
+// suspends takes about 25 times as long as game/Simple in bench.exe, which
+// is nothing beside a networked player's reply, but makes the scheduler a
+// poor fit for seats that answer at once; those should answer from
+// on_request, which never suspends.
+class TableScheduler {
+public:
+  static const size_t DEFAULT_STACK_SIZE = 256 * 1024;
+
+  // Thrown out of suspend() when the scheduler is destroyed with the table
+  // still suspended, to unwind the table's stack
+  struct Cancelled {};
+
+  //EFFECTS Initializes a scheduler whose tables get stacks of stack_size
+  //  bytes, which must hold the deepest search any of their players makes
+  explicit TableScheduler(size_t stack_size_in = DEFAULT_STACK_SIZE);
+
+  TableScheduler(const TableScheduler &) = delete;
+  TableScheduler & operator=(const TableScheduler &) = delete;
+
+  //REQUIRES no table is running
+  //EFFECTS Frees every table.  Each table that started but has not
+  //  finished is resumed one last time, with suspend() throwing Cancelled,
+  //  so that everything on its stack is destroyed.
+  ~TableScheduler();
+
+  //REQUIRES called on the scheduler thread, outside any table, and body
+  //  throws no exception but lets Cancelled pass through
+  //EFFECTS Adds a table that runs body, ready to start, and returns its id.
+  //  The ids and stacks of finished tables are reused.
+  int add_table(std::function<void()> body);
+
+  //REQUIRES called from inside a table
+  //EFFECTS Suspends the table until resume() is called for it.  Returns at
+  //  once if resume() was called since it last suspended.  Throws
+  //  Cancelled if the scheduler is being destroyed.
+  void suspend();
+
+  //EFFECTS Makes table run again once the scheduler gets to it, and does
+  //  nothing if it has finished.  Safe to call from any thread.
+  void resume(int table);
+
+  //EFFECTS Returns the id of the table running, or -1 outside any table
+  int current_table() const { return current; }
+
+  //REQUIRES called outside any table
+  //EFFECTS Runs tables until none is ready.  Returns the number of tables
+  //  that have not finished.
+  size_t run_ready();
+
+  //REQUIRES called outside any table
+  //EFFECTS Runs tables until every one has finished, waiting for resume()
+  //  whenever none is ready
+  void run();
+
+private:
+  struct Table;
+  struct Context;
+
+  size_t stack_size;
+  std::vector<std::unique_ptr<Table>> tables;
+  std::vector<int> spare;  // finished tables, for add_table to reuse
+  size_t unfinished = 0;
+  int current = -1;
+  bool cancelling = false;  // set by the destructor
+  std::unique_ptr<Context> scheduler_context;
+
+  std::mutex lock;
+  std::condition_variable wake;
+  std::deque<int> ready;
+
+  // Runs the table's body, then returns to the scheduler for good
+  static void start(unsigned low, unsigned high);
+
+  //REQUIRES table is RUNNING
+  //EFFECTS Switches from the scheduler to table until it suspends or
+  //  finishes
+  void switch_to(Table &table);
+};
+
+// What a seat must decide, as an AsyncSeat asks for it
+struct DecisionRequest {
+  int table = -1;
+  int seat = -1;
+  Decision decision = DECISION_MAKE_TRUMP;
+  Hand hand;             // the seat's cards
+  Card upcard;           // for DECISION_MAKE_TRUMP, DECISION_ADD_AND_DISCARD
+  bool is_dealer = false;
+  int round = 0;
+  Card led;              // for DECISION_PLAY_CARD
+  Suit trump = SPADES;   // for DECISION_LEAD_CARD, DECISION_PLAY_CARD
+};
+
+// A seat's answer to a DecisionRequest
+struct DecisionAnswer {
+  bool order_up = false; // for DECISION_MAKE_TRUMP
+  Suit suit = SPADES;    // the suit ordered up
+  Card card;             // the card discarded, led or played
+};
+
+//EFFECTS Returns true if answer is a legal answer to request.  A dealer
+//  must order up in round 2.
+bool is_legal_answer(const DecisionRequest &request,
+                     const DecisionAnswer &answer);
+
+//EFFECTS Returns the answer a Simple player gives to request
+DecisionAnswer simple_answer(const DecisionRequest &request);
+
+// A Player that asks for every decision and suspends its table until the
+// answer comes.  It keeps its own hand, so answers can be checked.
+class AsyncSeat : public Player {
+public:
+  // Called on the scheduler thread, from inside the table, whenever the
+  // seat must decide.  It may answer at once or arrange for answer() to be
+  // called later, from any thread.
+  using RequestHandler =
+      std::function<void(AsyncSeat &seat, const DecisionRequest &request)>;
+
+  //REQUIRES scheduler outlives the seat, and the seat only plays at tables
+  //  of scheduler
+  AsyncSeat(const std::string &name_in, TableScheduler &scheduler_in,
+            RequestHandler on_request_in);
+
+  const std::string & get_name() const override { return name; }
+  void add_card(const Card &c) override;
+  bool make_trump(const Card &upcard, bool is_dealer, int round,
+                  Suit &order_up_suit) const override;
+  Card add_and_discard(const Card &upcard) override;
+  Card lead_card(Suit trump) override;
+  Card play_card(const Card &led_card, Suit trump) override;
+  void observe_deal(int seat_in, int dealer, const Card &upcard) override;
+
+  //EFFECTS Gives the answer to the decision the seat is waiting for and
+  //  resumes its table.  Returns false, changing nothing, if the seat is
+  //  not waiting or the answer is not legal.  Safe to call from any thread.
+  bool answer(const DecisionAnswer &answer_in);
+
+private:
+  std::string name;
+  TableScheduler &scheduler;
+  RequestHandler on_request;
+  int seat = -1;
+  Hand hand;
+
+  // The decision waited for.  make_trump is const, so these are mutable.
+  mutable std::mutex lock;
+  mutable DecisionRequest request;
+  mutable DecisionAnswer reply;
+  mutable bool waiting = false;
+
+  // Asks for request and suspends until it is answered
+  DecisionAnswer ask(const DecisionRequest &request_in) const;
+};
+
+#endif // TABLE_SCHEDULER_HPP
@@ -0,0 +1,301 @@
+#include "TableScheduler.hpp"
+#include "Game.hpp"
+#include "unit_test_framework.hpp"
+
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+static const vector<string> NAMES = {"Ann", "Bob", "Cat", "Dan"};
+
+// Plays one shuffled game with players, returning its transcript
+static string play_game(const vector<Player*> &players, int g) {
+  ostringstream out;
+  TextSink transcript(out, NAMES);
+  Rng rng(24, g);
+  Pack pack;
+  Game game(pack, true, 10, players);
+  game.set_sink(transcript);
+  game.set_rng(&rng);
+  game.play();
+  return out.str();
+}
+
+// Requests waiting for an answer, shared between threads
+class Mailbox {
+public:
+  void post(AsyncSeat &seat, const DecisionRequest &request) {
+    lock_guard<mutex> guard(lock);
+    waiting.emplace_back(&seat, request);
+    wake.notify_one();
+  }
+
+  // Answers every request as a Simple player would, until closed
+  void answer_all() {
+    unique_lock<mutex> guard(lock);
+    while (true) {
+      wake.wait(guard, [this] { return closed || !waiting.empty(); });
+      if (waiting.empty()) {
+        return;
+      }
+      const pair<AsyncSeat*, DecisionRequest> next = waiting.front();
+      waiting.pop_front();
+      guard.unlock();
+      ASSERT_TRUE(next.first->answer(simple_answer(next.second)));
+      guard.lock();
+    }
+  }
+
+  void close() {
+    lock_guard<mutex> guard(lock);
+    closed = true;
+    wake.notify_one();
+  }
+
+private:
+  mutex lock;
+  condition_variable wake;
+  deque<pair<AsyncSeat*, DecisionRequest>> waiting;
+  bool closed = false;
+};
+
+TEST(test_scheduler_suspend_and_resume) {
+  TableScheduler scheduler;
+  vector<int> steps;
+  const int first = scheduler.add_table([&] {
+    steps.push_back(1);
+    scheduler.suspend();
+    steps.push_back(3);
+  });
+  const int second = scheduler.add_table([&] {
+    steps.push_back(2);
+    // Resumed while running, so the suspend returns at once
+    scheduler.resume(scheduler.current_table());
+    scheduler.suspend();
+    scheduler.suspend();
+    steps.push_back(4);
+  });
+  ASSERT_EQUAL(scheduler.current_table(), -1);
+  ASSERT_EQUAL(scheduler.run_ready(), 2u);
+  ASSERT_TRUE(steps == vector<int>({1, 2}));
+  ASSERT_EQUAL(scheduler.run_ready(), 2u);
+
+  scheduler.resume(first);
+  scheduler.resume(first);
+  scheduler.resume(second);
+  ASSERT_EQUAL(scheduler.run_ready(), 0u);
+  ASSERT_TRUE(steps == vector<int>({1, 2, 3, 4}));
+  // Resuming a finished table does nothing
+  scheduler.resume(first);
+  ASSERT_EQUAL(scheduler.run_ready(), 0u);
+
+  // New tables take the places of finished ones
+  const int third = scheduler.add_table([&] { steps.push_back(5); });
+  ASSERT_TRUE(third == first || third == second);
+  ASSERT_EQUAL(scheduler.run_ready(), 0u);
+  ASSERT_EQUAL(steps.back(), 5);
+}
+
+// Counts the live instances, to show a table's stack was unwound
+struct Tracked {
+  int &live;
+  explicit Tracked(int &live_in) : live(live_in) { ++live; }
+  ~Tracked() { --live; }
+};
+
+TEST(test_scheduler_unwinds_unfinished_tables) {
+  int live = 0;
+  bool finished = false;
+  {
+    TableScheduler scheduler;
+    for (int t = 0; t < 3; ++t) {
+      scheduler.add_table([&] {
+        Tracked outer(live);
+        {
+          Tracked inner(live);
+          scheduler.suspend();
+        }
+        finished = true;
+      });
+    }
+    ASSERT_EQUAL(scheduler.run_ready(), 3u);
+    ASSERT_EQUAL(live, 6);
+    // One ready to run again and one never started, as well as one waiting
+    scheduler.resume(0);
+    scheduler.add_table([&] { Tracked never(live); finished = true; });
+  }
+  ASSERT_EQUAL(live, 0);
+  ASSERT_FALSE(finished);
+
+  // A game waiting on its seats destroys its players
+  {
+    TableScheduler scheduler;
+    scheduler.add_table([&] {
+      Tracked game_alive(live);
+      vector<unique_ptr<AsyncSeat>> seats;
+      vector<Player*> players;
+      for (const string &name : NAMES) {
+        seats.emplace_back(new AsyncSeat(name, scheduler,
+                                         [](AsyncSeat &,
+                                            const DecisionRequest &) {}));
+        players.push_back(seats.back().get());
+      }
+      Pack pack;
+      Game game(pack, false, 10, players);
+      game.play();
+    });
+    ASSERT_EQUAL(scheduler.run_ready(), 1u);
+    ASSERT_EQUAL(live, 1);
+  }
+  ASSERT_EQUAL(live, 0);
+}
+
+TEST(test_async_seats_answered_from_another_thread) {
+  const int games = 20;
+  vector<string> expected(games);
+  for (int g = 0; g < games; ++g) {
+    vector<Player*> players;
+    for (const string &name : NAMES) {
+      players.push_back(Player_factory(name, "Simple"));
+    }
+    expected[g] = play_game(players, g);
+    for (Player *p : players) delete p;
+  }
+
+  // Every game runs at once, waiting on answers from another thread
+  TableScheduler scheduler;
+  Mailbox mailbox;
+  vector<string> transcripts(games);
+  for (int g = 0; g < games; ++g) {
+    scheduler.add_table([&, g] {
+      vector<unique_ptr<AsyncSeat>> seats;
+      vector<Player*> players;
+      for (const string &name : NAMES) {
+        seats.emplace_back(new AsyncSeat(name, scheduler,
+            [&](AsyncSeat &seat, const DecisionRequest &request) {
+              mailbox.post(seat, request);
+            }));
+        players.push_back(seats.back().get());
+      }
+      transcripts[g] = play_game(players, g);
+    });
+  }
+  thread answerer([&] { mailbox.answer_all(); });
+  scheduler.run();
+  mailbox.close();
+  answerer.join();
+  ASSERT_TRUE(transcripts == expected);
+}
+
+TEST(test_scheduler_interleaves_thousands_of_tables) {
+  const int tables = 2000;
+  TableScheduler scheduler(64 * 1024);
+  deque<pair<AsyncSeat*, DecisionRequest>> waiting;
+  int finished = 0;
+  for (int t = 0; t < tables; ++t) {
+    scheduler.add_table([&, t] {
+      vector<unique_ptr<AsyncSeat>> seats;
+      vector<Player*> players;
+      for (const string &name : NAMES) {
+        seats.emplace_back(new AsyncSeat(name, scheduler,
+            [&](AsyncSeat &seat, const DecisionRequest &request) {
+              waiting.emplace_back(&seat, request);
+            }));
+        players.push_back(seats.back().get());
+      }
+      Rng rng(25, t);
+      Pack pack;
+      Game game(pack, true, 5, players);
+      game.set_rng(&rng);
+      game.play();
+      ++finished;
+    });
+  }
+
+  // Answer one round of requests at a time, so every table waits on every
+  // decision while the others run
+  size_t most_waiting = 0;
+  while (scheduler.run_ready() > 0) {
+    most_waiting = max(most_waiting, waiting.size());
+    deque<pair<AsyncSeat*, DecisionRequest>> round;
+    round.swap(waiting);
+    for (const auto &next : round) {
+      ASSERT_TRUE(next.first->answer(simple_answer(next.second)));
+    }
+  }
+  ASSERT_EQUAL(finished, tables);
+  ASSERT_EQUAL(most_waiting, size_t(tables));
+}
+
+TEST(test_async_seat_rejects_illegal_answers) {
+  TableScheduler scheduler;
+  int rejected = 0;
+  int requests = 0;
+  auto check = [&](AsyncSeat &seat, const DecisionRequest &request) {
+    ++requests;
+    DecisionAnswer illegal;
+    switch (request.decision) {
+    case DECISION_MAKE_TRUMP:
+      // Order up the wrong suit for the round
+      illegal.order_up = true;
+      illegal.suit = request.round == 1 ? Suit_next(request.upcard.get_suit())
+                                        : request.upcard.get_suit();
+      break;
+    case DECISION_PLAY_CARD: {
+      // Renege, or play a card the seat does not hold if it cannot
+      const Hand can_play = legal_moves(request.hand, request.led,
+                                        request.trump);
+      const Hand renege = request.hand.without(can_play);
+      illegal.card = renege.empty() ? Hand::full().without(request.hand).first()
+                                    : renege.first();
+      break;
+    }
+    case DECISION_ADD_AND_DISCARD:
+      // A card the seat neither holds nor picks up
+      illegal.card = Hand::full().without(request.hand
+                                          | Hand::of(request.upcard)).first();
+      break;
+    default:
+      // A card the seat does not hold
+      illegal.card = Hand::full().without(request.hand).first();
+      break;
+    }
+    if (!seat.answer(illegal)) {
+      ++rejected;
+    }
+    ASSERT_TRUE(seat.answer(simple_answer(request)));
+    ASSERT_FALSE(seat.answer(simple_answer(request)));
+  };
+
+  scheduler.add_table([&] {
+    vector<unique_ptr<AsyncSeat>> seats;
+    vector<Player*> players;
+    for (const string &name : NAMES) {
+      seats.emplace_back(new AsyncSeat(name, scheduler, check));
+      players.push_back(seats.back().get());
+    }
+    Rng rng(26);
+    Pack pack;
+    Game game(pack, true, 10, players);
+    game.set_rng(&rng);
+    game.play();
+  });
+  scheduler.run();
+  ASSERT_TRUE(requests > 0);
+  ASSERT_EQUAL(rejected, requests);
+
+  DecisionRequest stuck;
+  stuck.is_dealer = true;
+  stuck.round = 2;
+  stuck.upcard = Card(JACK, HEARTS);
+  ASSERT_FALSE(is_legal_answer(stuck, DecisionAnswer()));
+  DecisionAnswer hearts;
+  hearts.order_up = true;
+  hearts.suit = HEARTS;
+  ASSERT_FALSE(is_legal_answer(stuck, hearts));
+  hearts.suit = DIAMONDS;
+  ASSERT_TRUE(is_legal_answer(stuck, hearts));
+}
+
+TEST_MAIN()
@@ -0,0 +1,90 @@
+// TranscriptWriter.cpp
+#include "TranscriptWriter.hpp"
+#include <cerrno>
+#include <unistd.h>
+
+using namespace std;
+
+TranscriptWriter::TranscriptWriter(int fd_in)
+  : fd(fd_in),
+    filling(new char[BLOCK_SIZE]),
+    draining(new char[BLOCK_SIZE]) {
+  setp(filling.get(), filling.get() + BLOCK_SIZE);
+  worker = thread([this] { drain(); });
+}
+
+TranscriptWriter::~TranscriptWriter() {
+  sync();
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  wake.notify_all();
+  worker.join();
+}
+
+bool TranscriptWriter::good() const {
+  lock_guard<mutex> guard(lock);
+  return !failed;
+}
+
+TranscriptWriter::int_type TranscriptWriter::overflow(int_type ch) {
+  hand_off();
+  if (traits_type::eq_int_type(ch, traits_type::eof())) {
+    return traits_type::not_eof(ch);
+  }
+  *pptr() = traits_type::to_char_type(ch);
+  pbump(1);
+  return ch;
+}
+
+int TranscriptWriter::sync() {
+  hand_off();
+  unique_lock<mutex> guard(lock);
+  wake.wait(guard, [this] { return !pending; });
+  return failed ? -1 : 0;
+}
+
+void TranscriptWriter::hand_off() {
+  const size_t size = pptr() - pbase();
+  if (size == 0) {
+    return;
+  }
+  {
+    unique_lock<mutex> guard(lock);
+    wake.wait(guard, [this] { return !pending; });
+    std::swap(filling, draining);
+    draining_size = size;
+    pending = true;
+  }
+  wake.notify_all();
+  setp(filling.get(), filling.get() + BLOCK_SIZE);
+}
+
+void TranscriptWriter::drain() {
+  unique_lock<mutex> guard(lock);
+  while (true) {
+    wake.wait(guard, [this] { return pending || stopping; });
+    if (!pending) {
+      return;
+    }
+    // The block is the thread's alone until pending is cleared
+    guard.unlock();
+    const char *next = draining.get();
+    size_t left = draining_size;
+    bool ok = true;
+    while (ok && left > 0) {
+      const ssize_t written = ::write(fd, next, left);
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      ok = written > 0;
+      next += ok ? written : 0;
+      left -= ok ? written : 0;
+    }
+    guard.lock();
+    failed = failed || !ok;
+    pending = false;
+    wake.notify_all();
+  }
+}
@@ -0,0 +1,63 @@
+#ifndef TRANSCRIPT_WRITER_HPP
+#define TRANSCRIPT_WRITER_HPP
+/* TranscriptWriter.hpp
+ *
+ * A stream buffer that collects output in large blocks and writes them to
+ * a file descriptor on a background thread
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+
+// An std::ostream over a TranscriptWriter formats straight into a block
+// allocated up front.  A full block goes to the background thread, which
+// writes it with as few write calls as the file allows, while output
+// carries on into a second block.  Flushing the stream waits until
+// everything so far is written.
+class TranscriptWriter : public std::streambuf {
+public:
+  static const size_t BLOCK_SIZE = 64 * 1024;
+
+  //REQUIRES fd stays open as long as the writer
+  //EFFECTS Initializes a writer that writes to fd, which it does not own
+  explicit TranscriptWriter(int fd_in);
+
+  TranscriptWriter(const TranscriptWriter &) = delete;
+  TranscriptWriter & operator=(const TranscriptWriter &) = delete;
+
+  //EFFECTS Writes everything still buffered and stops the thread
+  ~TranscriptWriter();
+
+  //EFFECTS Returns false if a write to the file has failed
+  bool good() const;
+
+protected:
+  int_type overflow(int_type ch) override;
+  int sync() override;
+
+private:
+  int fd;
+  std::unique_ptr<char[]> filling;  // the block output goes into
+  std::unique_ptr<char[]> draining; // the block the thread is writing
+  size_t draining_size = 0;
+
+  mutable std::mutex lock;
+  std::condition_variable wake;
+  bool pending = false;  // draining holds bytes not yet written
+  bool stopping = false;
+  bool failed = false;
+  std::thread worker;
+
+  // Hands the filled part of the block to the thread, once it is done
+  // with the last one
+  void hand_off();
+
+  // Writes each block handed off until stopped
+  void drain();
+};
+
+#endif // TRANSCRIPT_WRITER_HPP
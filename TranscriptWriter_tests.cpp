@@ -0,0 +1,96 @@
+#include "TranscriptWriter.hpp"
+#include "Game.hpp"
+#include "unit_test_framework.hpp"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace std;
+
+static const char *const OUTPUT_FILE = "TranscriptWriter_tests.out";
+
+// Returns everything in the file at path
+static string read_file(const string &path) {
+  ifstream in(path, ios::binary);
+  ostringstream contents;
+  contents << in.rdbuf();
+  return contents.str();
+}
+
+// Plays a game of Simple players, printing its transcript to os
+static void play_game(ostream &os, int points) {
+  vector<Player*> players;
+  for (const char *name : {"Ann", "Bob", "Cat", "Dan"}) {
+    players.push_back(Player_factory(name, "Simple"));
+  }
+  TextSink transcript(os, {"Ann", "Bob", "Cat", "Dan"});
+  Pack pack;
+  Game game(pack, true, points, players);
+  game.set_sink(transcript);
+  game.play();
+  for (Player *p : players) delete p;
+}
+
+TEST(test_writer_matches_ostream_byte_for_byte) {
+  ostringstream expected;
+  for (int points : {1, 10, 50}) {
+    play_game(expected, points);
+  }
+
+  const int fd = open(OUTPUT_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  ASSERT_TRUE(fd >= 0);
+  {
+    TranscriptWriter writer(fd);
+    ostream out(&writer);
+    for (int points : {1, 10, 50}) {
+      play_game(out, points);
+    }
+    // Each game's end flushes it to the file
+    ASSERT_EQUAL(read_file(OUTPUT_FILE), expected.str());
+    ASSERT_TRUE(writer.good());
+  }
+  close(fd);
+  ASSERT_EQUAL(read_file(OUTPUT_FILE), expected.str());
+  remove(OUTPUT_FILE);
+}
+
+TEST(test_writer_spans_many_blocks) {
+  string expected;
+  const int fd = open(OUTPUT_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  {
+    TranscriptWriter writer(fd);
+    ostream out(&writer);
+    for (int i = 0; i < 100000; ++i) {
+      const string line = "line " + to_string(i) + '\n';
+      out << line;
+      expected += line;
+    }
+    // One write larger than a whole block, then single characters
+    const string big(3 * TranscriptWriter::BLOCK_SIZE + 7, 'x');
+    out.write(big.data(), big.size());
+    expected += big;
+    for (char c : string("tail\n")) {
+      out.put(c);
+      expected += c;
+    }
+  }
+  close(fd);
+  ASSERT_EQUAL(read_file(OUTPUT_FILE), expected);
+  remove(OUTPUT_FILE);
+}
+
+TEST(test_writer_reports_failed_writes) {
+  const int fd = open(OUTPUT_FILE, O_RDONLY | O_CREAT, 0644);
+  TranscriptWriter writer(fd);
+  ostream out(&writer);
+  out << "cannot be written" << flush;
+  ASSERT_FALSE(bool(out));
+  ASSERT_FALSE(writer.good());
+  close(fd);
+  remove(OUTPUT_FILE);
+}
+
+TEST_MAIN()
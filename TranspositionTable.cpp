@@ -0,0 +1,74 @@
+// TranspositionTable.cpp
+#include "TranspositionTable.hpp"
+#include <cassert>
+
+using namespace std;
+
+// A data word: a flag so it is never 0, then lower, upper and depth bytes
+static uint64_t pack(const TranspositionTable::Entry &entry) {
+  return 1 | uint64_t(entry.lower) << 8 | uint64_t(entry.upper) << 16
+           | uint64_t(entry.depth) << 24;
+}
+
+static TranspositionTable::Entry unpack(uint64_t data) {
+  return {int(data >> 8 & 0xFF), int(data >> 16 & 0xFF),
+          int(data >> 24 & 0xFF)};
+}
+
+// Worth of keeping an entry: deeper searches cost more to redo, and an
+// exact value is worth more than a bound
+static int worth(uint64_t data) {
+  const TranspositionTable::Entry entry = unpack(data);
+  return 2 * entry.depth + (entry.lower == entry.upper);
+}
+
+TranspositionTable::TranspositionTable(int log2_buckets)
+  : buckets(size_t(1) << log2_buckets),
+    mask((uint64_t(1) << log2_buckets) - 1) {
+  assert(0 <= log2_buckets && log2_buckets <= 30);
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry &entry) const {
+  const Bucket &bucket = buckets[key & mask];
+  for (const Slot &slot : bucket.slots) {
+    const uint64_t data = slot.data.load(memory_order_relaxed);
+    const uint64_t check = slot.check.load(memory_order_relaxed);
+    if (data != 0 && (check ^ data) == key) {
+      entry = unpack(data);
+      return true;
+    }
+  }
+  return false;
+}
+
+void TranspositionTable::store(uint64_t key, const Entry &entry) {
+  assert(0 <= entry.lower && entry.lower <= entry.upper && entry.upper < 256);
+  assert(0 <= entry.depth && entry.depth < 128);
+  Bucket &bucket = buckets[key & mask];
+  int victim = 0;
+  int victim_worth = 0;
+  for (int i = 0; i < SLOTS; ++i) {
+    const uint64_t data = bucket.slots[i].data.load(memory_order_relaxed);
+    const uint64_t check = bucket.slots[i].check.load(memory_order_relaxed);
+    if (data == 0 || (check ^ data) == key) {
+      victim = i;
+      break;
+    }
+    if (i == 0 || worth(data) < victim_worth) {
+      victim = i;
+      victim_worth = worth(data);
+    }
+  }
+  const uint64_t data = pack(entry);
+  bucket.slots[victim].check.store(key ^ data, memory_order_relaxed);
+  bucket.slots[victim].data.store(data, memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+  for (Bucket &bucket : buckets) {
+    for (Slot &slot : bucket.slots) {
+      slot.check.store(0, memory_order_relaxed);
+      slot.data.store(0, memory_order_relaxed);
+    }
+  }
+}
@@ -0,0 +1,65 @@
+#ifndef TRANSPOSITION_TABLE_HPP
+#define TRANSPOSITION_TABLE_HPP
+/* TranspositionTable.hpp
+ *
+ * Fixed-size table of search bounds keyed by 64-bit position hashes, safe
+ * to share between search threads without locks
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Each bucket is one cache line of four entries.  An entry stores its data
+// word and the key XORed with that word; a reader accepts an entry only if
+// the two words XOR back to its key, so an entry torn by a concurrent
+// write reads as a miss instead of as wrong bounds.
+class TranspositionTable {
+public:
+  // Bounds on the value of a position, and how deep it was searched
+  struct Entry {
+    int lower;
+    int upper;
+    int depth;
+  };
+
+  static const int SLOTS = 4;
+  static const int DEFAULT_LOG2_BUCKETS = 12;
+
+  //REQUIRES 0 <= log2_buckets <= 30
+  //EFFECTS Makes an empty table of 2^log2_buckets buckets
+  explicit TranspositionTable(int log2_buckets = DEFAULT_LOG2_BUCKETS);
+
+  //MODIFIES entry
+  //EFFECTS Returns true and sets entry if key is in the table
+  bool probe(uint64_t key, Entry &entry) const;
+
+  //REQUIRES 0 <= lower <= upper < 256 and 0 <= depth < 128
+  //MODIFIES this table
+  //EFFECTS Stores entry under key.  It replaces key's old entry if there
+  //  is one, else an empty slot, else the slot in key's bucket that is
+  //  cheapest to lose: the shallowest, and of equal depths one holding
+  //  only a bound rather than an exact value.
+  void store(uint64_t key, const Entry &entry);
+
+  //MODIFIES this table
+  //EFFECTS Removes every entry.  Not safe while other threads use the table.
+  void clear();
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> check{0}; // key ^ data
+    std::atomic<uint64_t> data{0};  // 0 if empty
+  };
+
+  struct alignas(64) Bucket {
+    std::array<Slot, SLOTS> slots;
+  };
+  static_assert(sizeof(Bucket) == 64, "a bucket should fill a cache line");
+
+  std::vector<Bucket> buckets;
+  uint64_t mask;
+};
+
+#endif // TRANSPOSITION_TABLE_HPP
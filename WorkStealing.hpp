@@ -0,0 +1,151 @@
+#ifndef WORK_STEALING_HPP
+#define WORK_STEALING_HPP
+/* WorkStealing.hpp
+ *
+ * Runs a fixed set of independent tasks over several threads
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Each worker starts with a contiguous block of task ids in its own deque.
+// It takes work from the back of its own deque and, once that is empty,
+// steals from the front of the other workers' deques.  No tasks are added
+// after the start, so a worker that finds every deque empty is done.
+// The other workers' threads start with the pool and wait between runs, so
+// a pool kept across many short runs pays for its threads once.
+class WorkStealingPool {
+public:
+  // Called as fn(worker, task) for every task id, on the worker's thread
+  using TaskFn = std::function<void(int, int)>;
+
+  //REQUIRES num_workers > 0
+  //EFFECTS Initializes a pool that runs tasks on num_workers threads
+  explicit WorkStealingPool(int num_workers) : queues(num_workers) {
+    for (auto &queue : queues) {
+      queue.reset(new Queue());
+    }
+    for (int w = 1; w < num_workers; ++w) {
+      helpers.emplace_back([this, w]() { serve(w); });
+    }
+  }
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool & operator=(const WorkStealingPool &) = delete;
+
+  ~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(control);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &t : helpers) {
+      t.join();
+    }
+  }
+
+  //REQUIRES no other run is in progress
+  //EFFECTS Runs fn once for each task id in [0, num_tasks) and returns when
+  //  all of them have finished.  Worker 0 runs on the calling thread.
+  void run(int num_tasks, const TaskFn &fn) {
+    const int num_workers = static_cast<int>(queues.size());
+    for (int w = 0; w < num_workers; ++w) {
+      const int begin = static_cast<int>(long(num_tasks) * w / num_workers);
+      const int end = static_cast<int>(long(num_tasks) * (w + 1) / num_workers);
+      std::lock_guard<std::mutex> lock(queues[w]->mutex);
+      for (int task = begin; task < end; ++task) {
+        queues[w]->tasks.push_back(task);
+      }
+    }
+    {
+      std::lock_guard<std::mutex> lock(control);
+      task_fn = &fn;
+      busy = num_workers - 1;
+      ++generation;
+    }
+    wake.notify_all();
+    work(0, fn);
+    std::unique_lock<std::mutex> lock(control);
+    done.wait(lock, [this]() { return busy == 0; });
+    task_fn = nullptr;
+  }
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<int> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> helpers; // workers 1 and up
+
+  // Hands each run to the helpers
+  std::mutex control;
+  std::condition_variable wake;  // a run started, or the pool is stopping
+  std::condition_variable done;  // the last helper finished a run
+  const TaskFn *task_fn = nullptr;
+  unsigned long generation = 0;  // runs started
+  int busy = 0;                  // helpers still working on this run
+  bool stopping = false;
+
+  // A helper's life: work on each run as it starts
+  void serve(int worker) {
+    unsigned long seen = 0;
+    while (true) {
+      const TaskFn *fn;
+      {
+        std::unique_lock<std::mutex> lock(control);
+        wake.wait(lock, [&]() { return stopping || generation != seen; });
+        if (stopping) {
+          return;
+        }
+        seen = generation;
+        fn = task_fn;
+      }
+      work(worker, *fn);
+      std::lock_guard<std::mutex> lock(control);
+      if (--busy == 0) {
+        done.notify_one();
+      }
+    }
+  }
+
+  void work(int worker, const TaskFn &fn) {
+    int task = 0;
+    while (take(worker, task) || steal(worker, task)) {
+      fn(worker, task);
+    }
+  }
+
+  bool take(int worker, int &task) {
+    Queue &queue = *queues[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      return false;
+    }
+    task = queue.tasks.back();
+    queue.tasks.pop_back();
+    return true;
+  }
+
+  bool steal(int worker, int &task) {
+    const int num_workers = static_cast<int>(queues.size());
+    for (int i = 1; i < num_workers; ++i) {
+      Queue &victim = *queues[(worker + i) % num_workers];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = victim.tasks.front();
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+#endif // WORK_STEALING_HPP
@@ -0,0 +1,381 @@
+// bench.cpp
+// Micro and macro benchmarks, for catching performance regressions
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Card.hpp"
+#include "Game.hpp"
+#include "GameSink.hpp"
+#include "Hand.hpp"
+#include "Pack.hpp"
+#include "Player.hpp"
+#include "Random.hpp"
+#include "TableScheduler.hpp"
+#include "TranscriptWriter.hpp"
+
+using namespace std;
+
+static void print_usage_and_exit() {
+  cout << "Usage: bench.exe [--filter TEXT] [--reps N] [--min-ms N] "
+       << "[--json OUTPUT_FILENAME]" << endl;
+  exit(1);
+}
+
+struct Options {
+  string filter;    // run only benchmarks whose names contain this
+  int reps = 10;    // timed repetitions of each benchmark
+  int min_ms = 20;  // least time for one repetition
+  string json;      // file to write results to as JSON, if not empty
+};
+
+static Options parse_options(int argc, char **argv) {
+  Options opts;
+  if (argc % 2 != 1) print_usage_and_exit();
+  for (int i = 1; i < argc; i += 2) {
+    const string flag = argv[i];
+    if (flag == "--filter") {
+      opts.filter = argv[i + 1];
+    } else if (flag == "--reps") {
+      opts.reps = atoi(argv[i + 1]);
+      if (opts.reps < 2) print_usage_and_exit();
+    } else if (flag == "--min-ms") {
+      opts.min_ms = atoi(argv[i + 1]);
+      if (opts.min_ms < 1) print_usage_and_exit();
+    } else if (flag == "--json") {
+      opts.json = argv[i + 1];
+    } else {
+      print_usage_and_exit();
+    }
+  }
+  return opts;
+}
+
+// Keeps the compiler from discarding value as unused
+template <typename T>
+static void keep(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// A benchmark body runs its operation the given number of times
+using Body = function<void(long)>;
+
+struct Result {
+  string name;
+  long ops;            // operations per repetition
+  double mean_ns;      // mean time per operation over the repetitions
+  double variance_ns;  // sample variance of the time per operation
+  double min_ns;
+};
+
+using Clock = chrono::steady_clock;
+
+static double time_ns(const Body &body, long ops) {
+  const Clock::time_point start = Clock::now();
+  body(ops);
+  return chrono::duration<double, nano>(Clock::now() - start).count();
+}
+
+// Doubles the operations per repetition until one takes opts.min_ms, then
+// times opts.reps repetitions
+static Result measure(const string &name, const Body &body,
+                      const Options &opts) {
+  const double min_ns = opts.min_ms * 1e6;
+  long ops = 1;
+  while (time_ns(body, ops) < min_ns) {
+    ops *= 2;
+  }
+
+  vector<double> per_op;
+  for (int r = 0; r < opts.reps; ++r) {
+    per_op.push_back(time_ns(body, ops) / ops);
+  }
+  double sum = 0;
+  for (double t : per_op) {
+    sum += t;
+  }
+  const double mean = sum / per_op.size();
+  double squares = 0;
+  for (double t : per_op) {
+    squares += (t - mean) * (t - mean);
+  }
+  return {name, ops, mean, squares / (per_op.size() - 1),
+          *min_element(per_op.begin(), per_op.end())};
+}
+
+static void print_result(const Result &r) {
+  const double stddev = sqrt(r.variance_ns);
+  cout << left << setw(32) << r.name << right << fixed
+       << setprecision(2) << setw(14) << r.mean_ns << " ns/op"
+       << setprecision(0) << setw(14) << 1e9 / r.mean_ns << " ops/s"
+       << setprecision(1) << setw(8) << 100 * stddev / r.mean_ns << "% sd"
+       << endl;
+}
+
+static void write_json(ostream &os, const vector<Result> &results) {
+  os << "[\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result &r = results[i];
+    os << "  {\"name\": \"" << r.name << "\", \"ops_per_rep\": " << r.ops
+       << setprecision(6) << ", \"ns_per_op\": " << r.mean_ns
+       << ", \"ns_per_op_variance\": " << r.variance_ns
+       << ", \"ns_per_op_min\": " << r.min_ns
+       << ", \"ops_per_sec\": " << 1e9 / r.mean_ns << "}"
+       << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  os << "]" << endl;
+}
+
+/////////////// Inputs ///////////////
+
+// Random inputs, cycled through so each operation sees a different one
+static const int NUM_INPUTS = 1024;
+
+struct Inputs {
+  vector<Card> a, b, led;
+  vector<Suit> trump;
+  vector<Hand> hand;   // five cards, none of them a or b
+  vector<Hand> legal;  // hand's cards that may follow led
+  vector<Hand> picked_up; // hand with a added, as a dealer holds it
+};
+
+static Inputs make_inputs() {
+  Inputs in;
+  Rng rng(280);
+  Pack pack;
+  for (int i = 0; i < NUM_INPUTS; ++i) {
+    pack.shuffle(rng);
+    in.a.push_back(pack.deal_one());
+    in.b.push_back(pack.deal_one());
+    in.led.push_back(pack.deal_one());
+    in.trump.push_back(static_cast<Suit>(rng.below(4)));
+    Hand hand;
+    for (int c = 0; c < Player::MAX_HAND_SIZE; ++c) {
+      hand.add(pack.deal_one());
+    }
+    in.hand.push_back(hand);
+    in.legal.push_back(legal_moves(hand, in.led.back(), in.trump.back()));
+    in.picked_up.push_back(hand | Hand::of(in.a.back()));
+  }
+  return in;
+}
+
+/////////////// Macro benchmarks ///////////////
+
+// Four Simple players playing games to points_to_win from random deals
+class SimpleTable {
+public:
+  explicit SimpleTable(int points_to_win)
+    : players({Player_factory("A", "Simple"), Player_factory("B", "Simple"),
+               Player_factory("C", "Simple"), Player_factory("D", "Simple")}),
+      game(pack, true, points_to_win, players), rng(280) {
+    game.set_rng(&rng);
+  }
+
+  SimpleTable(const SimpleTable &) = delete;
+  SimpleTable & operator=(const SimpleTable &) = delete;
+
+  ~SimpleTable() {
+    for (Player *p : players) delete p;
+  }
+
+  Game & get_game() { return game; }
+
+private:
+  Pack pack;
+  vector<Player*> players;
+  Game game;
+  Rng rng;
+};
+
+/////////////// Main ///////////////
+
+int main(int argc, char **argv) {
+  const Options opts = parse_options(argc, argv);
+  const Inputs in = make_inputs();
+  const int mask = NUM_INPUTS - 1;
+
+  vector<pair<string, Body>> benchmarks = {
+    {"Card_less", [&](long n) {
+      for (long i = 0; i < n; ++i) {
+        keep(Card_less(in.a[i & mask], in.b[i & mask], in.trump[i & mask]));
+      }
+    }},
+    {"Card_less/led", [&](long n) {
+      for (long i = 0; i < n; ++i) {
+        keep(Card_less(in.a[i & mask], in.b[i & mask], in.led[i & mask],
+                       in.trump[i & mask]));
+      }
+    }},
+    {"Card::get_suit/trump", [&](long n) {
+      for (long i = 0; i < n; ++i) {
+        keep(in.a[i & mask].get_suit(in.trump[i & mask]));
+      }
+    }},
+    {"Pack::shuffle", [&](long n) {
+      Pack pack;
+      for (long i = 0; i < n; ++i) {
+        pack.shuffle();
+        keep(pack);
+      }
+    }},
+    {"Pack::shuffle/rng", [&](long n) {
+      Pack pack;
+      Rng rng(1);
+      for (long i = 0; i < n; ++i) {
+        pack.shuffle(rng);
+        keep(pack);
+      }
+    }},
+    {"Pack::deal_one", [&](long n) {
+      Pack pack;
+      for (long i = 0; i < n; ++i) {
+        if (pack.empty()) pack.reset();
+        keep(pack.deal_one());
+      }
+    }},
+    {"Simple/make_trump/round1", [&](long n) {
+      for (long i = 0; i < n; ++i) {
+        Suit suit;
+        keep(simple_make_trump(in.hand[i & mask], in.a[i & mask], i & 1, 1,
+                               suit));
+      }
+    }},
+    {"Simple/make_trump/round2", [&](long n) {
+      for (long i = 0; i < n; ++i) {
+        Suit suit;
+        keep(simple_make_trump(in.hand[i & mask], in.a[i & mask], i & 1, 2,
+                               suit));
+      }
+    }},
+    {"Simple/discard", [&](long n) {
+      for (long i = 0; i < n; ++i) {
+        keep(simple_discard(in.picked_up[i & mask], in.a[i & mask]));
+      }
+    }},
+    {"Simple/lead_card", [&](long n) {
+      for (long i = 0; i < n; ++i) {
+        keep(simple_lead(in.hand[i & mask], in.trump[i & mask]));
+      }
+    }},
+    {"Simple/play_card", [&](long n) {
+      for (long i = 0; i < n; ++i) {
+        keep(simple_play(in.hand[i & mask], in.led[i & mask],
+                         in.trump[i & mask]));
+      }
+    }},
+    {"hand/Simple", [&](long n) {
+      SimpleTable table(1);
+      for (long i = 0; i < n; ++i) {
+        table.get_game().play();
+      }
+    }},
+    {"game/Simple", [&](long n) {
+      SimpleTable table(10);
+      for (long i = 0; i < n; ++i) {
+        table.get_game().play();
+      }
+    }},
+    {"game/Simple/transcript", [&](long n) {
+      SimpleTable table(10);
+      ostringstream transcript;
+      TextSink sink(transcript, {"A", "B", "C", "D"});
+      table.get_game().set_sink(sink);
+      for (long i = 0; i < n; ++i) {
+        transcript.str("");
+        table.get_game().play();
+      }
+    }},
+    {"game/Simple/transcript-file", [&](long n) {
+      SimpleTable table(10);
+      const int fd = open("/dev/null", O_WRONLY);
+      {
+        TranscriptWriter writer(fd);
+        ostream transcript(&writer);
+        TextSink sink(transcript, {"A", "B", "C", "D"});
+        table.get_game().set_sink(sink);
+        for (long i = 0; i < n; ++i) {
+          table.get_game().play();
+        }
+      }
+      close(fd);
+    }},
+    {"game/Simple/async-seats", [&](long n) {
+      // Every decision asked of an AsyncSeat but answered at once, so no
+      // table ever suspends: the cost of asking without switching
+      TableScheduler scheduler(64 * 1024);
+      const AsyncSeat::RequestHandler answer =
+          [](AsyncSeat &seat, const DecisionRequest &request) {
+            seat.answer(simple_answer(request));
+          };
+      for (long i = 0; i < n; ++i) {
+        scheduler.add_table([&, i] {
+          AsyncSeat a("A", scheduler, answer), b("B", scheduler, answer),
+                    c("C", scheduler, answer), d("D", scheduler, answer);
+          Rng rng(280, i);
+          Pack pack;
+          Game game(pack, true, 10, {&a, &b, &c, &d});
+          game.set_rng(&rng);
+          game.play();
+        });
+        scheduler.run_ready();
+      }
+    }},
+    {"game/Simple/async-tables", [&](long n) {
+      // n games at once, each seat waiting on its table for every decision
+      TableScheduler scheduler(64 * 1024);
+      vector<pair<AsyncSeat*, DecisionRequest>> waiting, answering;
+      const AsyncSeat::RequestHandler post =
+          [&](AsyncSeat &seat, const DecisionRequest &request) {
+            waiting.emplace_back(&seat, request);
+          };
+      for (long i = 0; i < n; ++i) {
+        scheduler.add_table([&, i] {
+          AsyncSeat a("A", scheduler, post), b("B", scheduler, post),
+                    c("C", scheduler, post), d("D", scheduler, post);
+          Rng rng(280, i);
+          Pack pack;
+          Game game(pack, true, 10, {&a, &b, &c, &d});
+          game.set_rng(&rng);
+          game.play();
+        });
+      }
+      while (scheduler.run_ready() > 0) {
+        answering.swap(waiting);
+        for (const auto &next : answering) {
+          next.first->answer(simple_answer(next.second));
+        }
+        answering.clear();
+      }
+    }},
+  };
+
+  vector<Result> results;
+  for (const auto &benchmark : benchmarks) {
+    if (benchmark.first.find(opts.filter) == string::npos) {
+      continue;
+    }
+    results.push_back(measure(benchmark.first, benchmark.second, opts));
+    print_result(results.back());
+  }
+
+  if (!opts.json.empty()) {
+    ofstream out(opts.json);
+    write_json(out, results);
+    if (!out) {
+      cout << "Error writing " << opts.json << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
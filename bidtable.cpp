@@ -0,0 +1,49 @@
+// bidtable.cpp
+// Generates the bid-strength table that BidTable players look up
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "BidTable.hpp"
+
+using namespace std;
+
+static void print_usage_and_exit() {
+  cout << "Usage: bidtable.exe OUTPUT_FILENAME [--rollouts N] [--threads N] "
+       << "[--seed SEED]" << endl;
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc % 2 != 0) print_usage_and_exit();
+  int rollouts = 64;
+  int threads = 0;   // one per core
+  uint64_t seed = 0;
+  for (int i = 2; i < argc; i += 2) {
+    const string flag = argv[i];
+    if (flag == "--rollouts") {
+      rollouts = atoi(argv[i + 1]);
+      if (rollouts < 1) print_usage_and_exit();
+    } else if (flag == "--threads") {
+      threads = atoi(argv[i + 1]);
+      if (threads < 0) print_usage_and_exit();
+    } else if (flag == "--seed") {
+      seed = strtoull(argv[i + 1], nullptr, 10);
+    } else {
+      print_usage_and_exit();
+    }
+  }
+  if (threads == 0) {
+    threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+  }
+
+  const vector<unsigned char> entries =
+      generate_bid_table(rollouts, threads, seed);
+  if (!BidTable::write(argv[1], rollouts, entries)) {
+    cout << "Error writing " << argv[1] << endl;
+    return 1;
+  }
+  return 0;
+}
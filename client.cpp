@@ -0,0 +1,74 @@
+// client.cpp
+// Plays games against euchre.exe --serve from many connections at once,
+// each answering as a Simple player, and reports how quickly it answered
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "GameServer.hpp"
+#include "Latency.hpp"
+
+using namespace std;
+
+static void print_usage_and_exit() {
+  cout << "Usage: client.exe PORT|SOCKET_PATH [--clients N] [--games N] "
+       << "[--players N]" << endl;
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc % 2 != 0) print_usage_and_exit();
+  int clients = 1;
+  int games = 1;    // each client plays this many, one after another
+  int players = 1;  // connected players at each table
+  for (int i = 2; i < argc; i += 2) {
+    const string flag = argv[i];
+    if (flag == "--clients") {
+      clients = atoi(argv[i + 1]);
+      if (clients < 1) print_usage_and_exit();
+    } else if (flag == "--games") {
+      games = atoi(argv[i + 1]);
+      if (games < 1) print_usage_and_exit();
+    } else if (flag == "--players") {
+      players = atoi(argv[i + 1]);
+      if (players < 1 || players > 4) print_usage_and_exit();
+    } else {
+      print_usage_and_exit();
+    }
+  }
+  // Otherwise the last table would wait for players forever
+  if (clients % players != 0) print_usage_and_exit();
+
+  LatencyHistogram latencies;
+  vector<int> played(clients, 0);
+  vector<thread> threads;
+  for (int c = 0; c < clients; ++c) {
+    threads.emplace_back([&, c] {
+      SimpleClient client;
+      if (!client.connect(argv[1])) {
+        return;
+      }
+      string transcript;
+      const string name = "Client" + to_string(c);
+      while (played[c] < games
+             && client.play(name, players, transcript, &latencies)) {
+        ++played[c];
+      }
+    });
+  }
+  for (thread &t : threads) {
+    t.join();
+  }
+
+  int total = 0;
+  for (int n : played) total += n;
+  cout << "games " << total << '\n'
+       << "decisions " << latencies.count() << '\n'
+       << "p50_ns " << latencies.percentile(0.5) << '\n'
+       << "p99_ns " << latencies.percentile(0.99) << '\n'
+       << "p999_ns " << latencies.percentile(0.999) << '\n'
+       << "max_ns " << latencies.max() << endl;
+  return total == clients * games ? 0 : 1;
+}
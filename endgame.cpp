@@ -0,0 +1,47 @@
+// endgame.cpp
+// Generates the endgame table that solvers and MonteCarlo players look up
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "EndgameTable.hpp"
+
+using namespace std;
+
+static void print_usage_and_exit() {
+  cout << "Usage: endgame.exe OUTPUT_FILENAME [--tricks N] [--threads N]"
+       << endl;
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc % 2 != 0) print_usage_and_exit();
+  int tricks = 2;
+  int threads = 0;   // one per core
+  for (int i = 2; i < argc; i += 2) {
+    const string flag = argv[i];
+    if (flag == "--tricks") {
+      tricks = atoi(argv[i + 1]);
+      if (tricks < 1 || tricks > EndgameTable::MAX_TRICKS) {
+        print_usage_and_exit();
+      }
+    } else if (flag == "--threads") {
+      threads = atoi(argv[i + 1]);
+      if (threads < 0) print_usage_and_exit();
+    } else {
+      print_usage_and_exit();
+    }
+  }
+  if (threads == 0) {
+    threads = max(1, static_cast<int>(thread::hardware_concurrency()));
+  }
+
+  const vector<unsigned char> entries = generate_endgame_table(tricks, threads);
+  if (!EndgameTable::write(argv[1], tricks, entries)) {
+    cout << "Error writing " << argv[1] << endl;
+    return 1;
+  }
+  return 0;
+}
@@ -1,257 +1,258 @@
 // euchre.cpp
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <string>
 #include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <csignal>
+#include <unistd.h>
 
 #include "Card.hpp"
+#include "Game.hpp"
+#include "GameRecord.hpp"
+#include "GameServer.hpp"
+#include "GameSink.hpp"
+#include "Latency.hpp"
 #include "Pack.hpp"
 #include "Player.hpp"
+#include "TranscriptWriter.hpp"
+#include "WorkStealing.hpp"
 
 using namespace std;
 
-static string suit_to_string(Suit s) {
-  switch (s) {
-    case SPADES:   return "Spades";
-    case HEARTS:   return "Hearts";
-    case CLUBS:    return "Clubs";
-    case DIAMONDS: return "Diamonds";
-  }
-  return "";
+static void print_usage_and_exit() {
+  cout << "Usage: euchre.exe PACK_FILENAME [shuffle|noshuffle] "
+       << "POINTS_TO_WIN NAME1 TYPE1 NAME2 TYPE2 NAME3 TYPE3 "
+       << "NAME4 TYPE4 [--simulate GAMES] [--seed SEED] [--threads N] "
+       << "[--latency SECONDS] [--record RECORD_FILENAME]"
+       << endl
+       << "       euchre.exe --serve PORT|SOCKET_PATH [--points POINTS_TO_WIN] "
+       << "[--seed SEED]"
+       << endl
+       << "TYPE is Simple, Human, "
+       << "MonteCarlo[:SAMPLES|:MILLISms[:THREADS[:ENDGAME_FILENAME]]], "
+       << "Ismcts[:ITERATIONS|:MILLISms] or BidTable[:TABLE_FILENAME]"
+       << endl;
+  exit(1);
 }
 
-class Game {
-public:
-  Game(Pack &pack_in, bool do_shuffle_in, int points_to_win_in,
-       const vector<Player*> &players_in)
-      : pack(pack_in),
-        do_shuffle(do_shuffle_in),
-        points_to_win(points_to_win_in),
-        players(players_in),
-        dealer(0),
-        hand_number(0) {}
-
-  void play() {
-    int team0_points = 0; // players 0 & 2
-    int team1_points = 0; // players 1 & 3
-
-    while (team0_points < points_to_win && team1_points < points_to_win) {
-      announce_hand_start();
-
-      // Reset/shuffle at the start of *each* hand per spec
-      if (do_shuffle) {
-        pack.shuffle();
-      } else {
-        pack.reset();
-      }
-
-      deal();
-
-      // Turn up the next card
-      const Card upcard = pack.deal_one();
-      cout << upcard << " turned up" << endl;
-
-      // Make trump
-      Suit trump = SPADES;        // will be set by make_trump()
-      int maker_index = -1;
-      make_trump(upcard, dealer, trump, maker_index);
-      cout << endl; // extra newline when making/adding/discarding completes
-
-      // Play the 5 tricks
-      const pair<int,int> tricks = play_hand((dealer + 1) % 4, trump);
-
-      // Score the hand
-      ScoreState s{tricks.first, tricks.second, team0_points, team1_points};
-      apply_scoring(maker_index, s);
-
-      // Print score w/ extra newline
-      print_scores(team0_points, team1_points);
-
-      // Next hand
-      dealer = (dealer + 1) % 4;
-      ++hand_number;
-    }
-
-    announce_game_winner(team0_points, team1_points);
-  }
-
-private:
-  Pack &pack;
-  bool do_shuffle;
-  int points_to_win;
-  vector<Player*> players;
-  int dealer;
-  int hand_number;
-
-  void announce_hand_start() const {
-    cout << "Hand " << hand_number << endl;
-    cout << players[dealer]->get_name() << " deals" << endl;
-  }
-
- void deal() {
-  // Round 1 (left of dealer): 3-2-3-2
-  const int r1[4] = {3, 2, 3, 2};
-  // Round 2 (left of dealer): 2-3-2-3
-  const int r2[4] = {2, 3, 2, 3};
+// Optional arguments that may follow the eleven standard ones
+struct Options {
+  int simulate_games = 0; // 0 plays one game and prints its transcript
+  bool seeded = false;    // game g shuffles at random from stream g of seed
+  uint64_t seed = 0;
+  int threads = 1;        // simulation threads, 0 for one per core
+  int latency_seconds = -1; // if 0 or more, time every decision and print
+                            // the latencies to stderr at the end, and
+                            // also this often if positive
+  string record_filename; // if set, every game's record is written here
+};
 
-  for (int i = 1; i <= 4; ++i) {
-    int p = (dealer + i) % 4;
-    for (int c = 0; c < r1[i - 1]; ++c) {
-      players[p]->add_card(pack.deal_one());
-    }
-  }
-  for (int i = 1; i <= 4; ++i) {
-    int p = (dealer + i) % 4;
-    for (int c = 0; c < r2[i - 1]; ++c) {
-      players[p]->add_card(pack.deal_one());
+static Options parse_options(int argc, char **argv) {
+  Options opts;
+  for (int i = 12; i < argc; i += 2) {
+    const string flag = argv[i];
+    if (i + 1 >= argc) print_usage_and_exit();
+    if (flag == "--simulate") {
+      opts.simulate_games = atoi(argv[i + 1]);
+      if (opts.simulate_games < 1) print_usage_and_exit();
+    } else if (flag == "--seed") {
+      opts.seeded = true;
+      opts.seed = strtoull(argv[i + 1], nullptr, 10);
+    } else if (flag == "--threads") {
+      opts.threads = atoi(argv[i + 1]);
+      if (opts.threads < 0) print_usage_and_exit();
+    } else if (flag == "--latency") {
+      opts.latency_seconds = atoi(argv[i + 1]);
+      if (opts.latency_seconds < 0) print_usage_and_exit();
+    } else if (flag == "--record") {
+      opts.record_filename = argv[i + 1];
+    } else {
+      print_usage_and_exit();
     }
   }
+  return opts;
 }
 
-  // Handles both rounds of making trump and dealer add/discard if ordered up
-  void make_trump(const Card &upcard, int dealer_index,
-                  Suit &trump_suit, int &maker_index) {
-    // Round 1: order up upcard suit
-    for (int i = 1; i <= 4; ++i) {
-      int idx = (dealer_index + i) % 4;
-      bool is_dealer = (idx == dealer_index);
-      if (players[idx]->make_trump(upcard, is_dealer, 1, trump_suit)) {
-        cout << players[idx]->get_name()
-             << " orders up " << suit_to_string(trump_suit) << endl;
-        maker_index = idx;
-        // Dealer must add and discard
-        players[dealer_index]->add_and_discard(upcard);
-        return;
-      } else {
-        cout << players[idx]->get_name() << " passes" << endl;
-      }
-    }
+// Player names and strategies, seat by seat
+using Seats = vector<pair<string, string>>;
 
-    // Round 2: call a different suit
-    for (int i = 1; i <= 4; ++i) {
-      int idx = (dealer_index + i) % 4;
-      bool is_dealer = (idx == dealer_index);
-      if (players[idx]->make_trump(upcard, is_dealer, 2, trump_suit)) {
-        cout << players[idx]->get_name()
-             << " orders up " << suit_to_string(trump_suit) << endl;
-        maker_index = idx;
-        return;
-      } else {
-        cout << players[idx]->get_name() << " passes" << endl;
-      }
+// Makes the players, timing their decisions in latencies if it is given
+static vector<Player*> make_players(const Seats &seats,
+                                    DecisionLatencies *latencies) {
+  vector<Player*> players;
+  for (const auto &seat : seats) {
+    Player *player = Player_factory(seat.first, seat.second);
+    if (latencies) {
+      player = Player_timed(player, seat.second, *latencies);
     }
-
-    // By project rules/tests this shouldn't happen (someone must choose),
-    // but guard anyway to avoid UB in scoring.
-    // Fallback: dealer becomes maker with next suit (rare; not used by tests).
-    maker_index = dealer_index;
-    trump_suit = upcard.get_suit(); // reasonable default
+    players.push_back(player);
   }
+  return players;
+}
 
-  pair<int,int> play_hand(int leader, Suit trump) {
-    int team0_tricks = 0;
-    int team1_tricks = 0;
+// The players' names, seat by seat
+static vector<string> seat_names(const Seats &seats) {
+  vector<string> names;
+  for (const auto &seat : seats) names.push_back(seat.first);
+  return names;
+}
 
-    for (int t = 0; t < 5; ++t) {
-      int winner = play_trick(leader, trump);
-      if (winner % 2 == 0) ++team0_tricks; else ++team1_tricks;
-      leader = winner; // winner leads next trick
+// Everything one simulation thread needs to play games on its own
+struct Table {
+  Pack pack;
+  Rng rng;  // reseeded for every game when seeded
+  vector<Player*> players;
+  StatsSink stats;
+  ostringstream recorded;  // records of the games played since last taken
+  unique_ptr<RecordSink> record;
+  unique_ptr<TeeSink> both;
+  Game game;
+
+  Table(const Pack &pack_in, const Seats &seats, bool do_shuffle,
+        int points_to_win, DecisionLatencies *latencies, bool seeded,
+        bool recording)
+    : pack(pack_in),
+      rng(0),
+      players(make_players(seats, latencies)),
+      game(pack, do_shuffle, points_to_win, players) {
+    game.set_sink(stats);
+    if (seeded) {
+      game.set_rng(&rng);
     }
-
-    // Announce hand winner (lower index partnership printed first)
-    if (team0_tricks > team1_tricks) {
-      cout << players[0]->get_name() << " and "
-           << players[2]->get_name() << " win the hand" << endl;
-    } else {
-      cout << players[1]->get_name() << " and "
-           << players[3]->get_name() << " win the hand" << endl;
+    if (recording) {
+      record.reset(new RecordSink(recorded, seat_names(seats),
+                                  points_to_win));
+      both.reset(new TeeSink(stats, *record));
+      game.set_sink(*both);
     }
-    return {team0_tricks, team1_tricks};
   }
 
-  int play_trick(int leader, Suit trump) {
-    Card led = players[leader]->lead_card(trump);
-    cout << led << " led by " << players[leader]->get_name() << endl;
-
-    int winning_index = leader;
-    Card winning_card = led;
+  ~Table() {
+    for (Player* p : players) delete p;
+  }
+};
 
-    for (int i = 1; i <= 3; ++i) {
-      int idx = (leader + i) % 4;
-      Card played = players[idx]->play_card(led, trump);
-      cout << played << " played by " << players[idx]->get_name() << endl;
+// Games handed to a worker at a time
+static const int GAMES_PER_TASK = 64;
+
+// Plays opts.simulate_games independent games spread over opts.threads
+// threads.  Every game starts from the pack file order, and with --seed
+// game g shuffles from stream g, so totals do not depend on the threads.
+// With records, every game's record goes to records in game order.
+static GameStats simulate(const Pack &pack, const Seats &seats,
+                            const Options &opts, bool do_shuffle,
+                            int points_to_win, DecisionLatencies *latencies,
+                            ostream *records) {
+  const int threads = opts.threads > 0
+      ? opts.threads : max(1, static_cast<int>(thread::hardware_concurrency()));
+  vector<unique_ptr<Table>> tables;
+  for (int t = 0; t < threads; ++t) {
+    tables.emplace_back(new Table(pack, seats, do_shuffle, points_to_win,
+                                  latencies, opts.seeded,
+                                  records != nullptr));
+  }
 
-      if (Card_less(winning_card, played, led, trump)) {
-        winning_card = played;
-        winning_index = idx;
+  const int games = opts.simulate_games;
+  const int tasks = (games + GAMES_PER_TASK - 1) / GAMES_PER_TASK;
+
+  // A task's records wait until those of every task before it are written
+  mutex records_lock;
+  vector<string> task_records(tasks);
+  vector<bool> task_done(tasks, false);
+  int next_task = 0;  // the first task whose records are not written
+
+  WorkStealingPool pool(threads);
+  pool.run(tasks, [&](int worker, int task) {
+    Table &table = *tables[worker];
+    const int end = min(games, (task + 1) * GAMES_PER_TASK);
+    for (int g = task * GAMES_PER_TASK; g < end; ++g) {
+      table.rng = Rng(opts.seed, g);
+      table.pack = pack;
+      table.game.play();
+    }
+    if (records) {
+      string done = table.recorded.str();
+      table.recorded.str("");
+      lock_guard<mutex> guard(records_lock);
+      task_records[task] = move(done);
+      task_done[task] = true;
+      for (; next_task < tasks && task_done[next_task]; ++next_task) {
+        *records << task_records[next_task];
+        string().swap(task_records[next_task]);
       }
     }
+  });
 
-    cout << players[winning_index]->get_name() << " takes the trick" << endl;
-    cout << endl; // extra newline after each trick
-    return winning_index;
+  GameStats total;
+  for (const auto &table : tables) {
+    total += table->stats.get_stats();
   }
+  return total;
+}
 
-  struct ScoreState {
-    int team0_tricks;
-    int team1_tricks;
-    int &team0_points;
-    int &team1_points;
-  };
+// Prints totals for a headless run, one "label value" pair per line
+static void print_stats(const GameStats &stats, int games,
+                        const Seats &seats) {
+  cout << "games " << games << '\n'
+       << seats[0].first << " and " << seats[2].first
+       << " win " << stats.team_wins[0] << '\n'
+       << seats[1].first << " and " << seats[3].first
+       << " win " << stats.team_wins[1] << '\n'
+       << "hands " << stats.hands << '\n'
+       << "march " << stats.marches << '\n'
+       << "euchred " << stats.euchres << endl;
+}
 
+// The server serve() runs, for stopping it on a signal
+static GameServer *serving = nullptr;
 
-  void apply_scoring(int maker_index, const ScoreState &s) const {
-    const bool maker_team0 = (maker_index % 2 == 0);
+static void stop_serving(int) {
+  serving->stop();
+}
 
-    if (maker_team0) {
-      if (s.team0_tricks >= 3) {
-        if (s.team0_tricks == 5) cout << "march!" << endl;
-        s.team0_points += (s.team0_tricks == 5 ? 2 : 1);
-      } else {
-        cout << "euchred!" << endl;
-        s.team1_points += 2;
-      }
+// Hosts tables for players connecting to argv[2] until interrupted
+static int serve(int argc, char **argv) {
+  if (argc % 2 != 1) print_usage_and_exit();
+  int points_to_win = 10;
+  uint64_t seed = 0;
+  for (int i = 3; i < argc; i += 2) {
+    const string flag = argv[i];
+    if (flag == "--points") {
+      points_to_win = atoi(argv[i + 1]);
+      if (points_to_win < 1 || points_to_win > 100) print_usage_and_exit();
+    } else if (flag == "--seed") {
+      seed = strtoull(argv[i + 1], nullptr, 10);
     } else {
-      if (s.team1_tricks >= 3) {
-        if (s.team1_tricks == 5) cout << "march!" << endl;
-        s.team1_points += (s.team1_tricks == 5 ? 2 : 1);
-      } else {
-        cout << "euchred!" << endl;
-        s.team0_points += 2;
-      }
+      print_usage_and_exit();
     }
   }
 
-  void print_scores(int team0_points, int team1_points) const {
-    cout << players[0]->get_name() << " and " << players[2]->get_name()
-         << " have " << team0_points << " points" << endl;
-    cout << players[1]->get_name() << " and " << players[3]->get_name()
-         << " have " << team1_points << " points" << endl;
-    cout << endl;
-  }
-
-  void announce_game_winner(int team0_points, int team1_points) const {
-    if (team0_points >= points_to_win) {
-      cout << players[0]->get_name() << " and " << players[2]->get_name()
-           << " win!" << endl;
-    } else {
-      cout << players[1]->get_name() << " and " << players[3]->get_name()
-           << " win!" << endl;
-    }
+  GameServer server(points_to_win, seed);
+  if (!server.listen(argv[2])) {
+    cout << "Error listening on " << argv[2] << endl;
+    return 1;
   }
-};
-
-static void print_usage_and_exit() {
-  cout << "Usage: euchre.exe PACK_FILENAME [shuffle|noshuffle] "
-       << "POINTS_TO_WIN NAME1 TYPE1 NAME2 TYPE2 NAME3 TYPE3 "
-       << "NAME4 TYPE4" << endl;
-  exit(1);
+  serving = &server;
+  signal(SIGINT, stop_serving);
+  signal(SIGTERM, stop_serving);
+  server.run();
+  return 0;
 }
 
 int main(int argc, char **argv) {
-  // Expect exactly 12 args (including executable)
-  if (argc != 12) print_usage_and_exit();
+  if (argc >= 3 && string(argv[1]) == "--serve") {
+    return serve(argc, argv);
+  }
+
+  // Expect 12 args (including executable) plus optional flag/value pairs
+  if (argc < 12) print_usage_and_exit();
+  const Options opts = parse_options(argc, argv);
 
   const string pack_filename = argv[1];
   const string shuffle_arg  = argv[2];
@@ -267,31 +268,107 @@ int main(int argc, char **argv) {
   }
 
   // Print the command line (with trailing space)
+  string command_line;
   for (int i = 0; i < argc; ++i) {
-    cout << argv[i] << " ";
+    command_line += argv[i];
+    command_line += " ";
+  }
+  command_line += "\n";
+  if (opts.simulate_games == 0) {
+    cout << command_line << flush;
   }
-  cout << endl;
 
   Pack pack(pack_file);
   const bool do_shuffle = (shuffle_arg == "shuffle");
 
-  vector<Player*> players;
-  players.reserve(4);
+  Seats seats;
   for (int i = 0; i < 4; ++i) {
     const string name = argv[4 + i * 2];
     const string type = argv[5 + i * 2];
-    if (type != "Simple" && type != "Human") {
-      for (Player* p : players) delete p;
-      print_usage_and_exit();
+    Player *probe = Player_factory(name, type);
+    if (!probe) print_usage_and_exit();
+    delete probe;
+    seats.emplace_back(name, type);
+  }
+  DecisionLatencies latencies;
+  DecisionLatencies *timed = opts.latency_seconds >= 0 ? &latencies : nullptr;
+  unique_ptr<LatencyReporter> reporter;
+  if (opts.latency_seconds > 0) {
+    reporter.reset(new LatencyReporter(
+        latencies, cerr, chrono::seconds(opts.latency_seconds)));
+  }
+
+  // The records replay to the whole output, so they start with the command
+  // line
+  ofstream record_file;
+  if (!opts.record_filename.empty()) {
+    record_file.open(opts.record_filename, ios::binary);
+    if (!record_file.is_open()) {
+      cout << "Error opening " << opts.record_filename << endl;
+      return 1;
     }
-    players.push_back(Player_factory(name, type));
+    write_record_preamble(record_file, command_line);
   }
 
-  Game game(pack, do_shuffle, points_to_win, players);
-  game.play();
+  int status = 0;
+  if (opts.simulate_games == 0) {
+    Rng rng(opts.seed);
+    const vector<string> names = seat_names(seats);
+
+    // Human players prompt on cout between transcript lines, so only games
+    // without them write the transcript from a background thread
+    unique_ptr<TranscriptWriter> writer;
+    unique_ptr<ostream> buffered;
+    ostream *out = &cout;
+    if (none_of(seats.begin(), seats.end(),
+                [](const pair<string, string> &seat) {
+          return seat.second == "Human";
+        })) {
+      writer.reset(new TranscriptWriter(STDOUT_FILENO));
+      buffered.reset(new ostream(writer.get()));
+      out = buffered.get();
+    }
+    TextSink transcript(*out, names);
+    vector<Player*> players = make_players(seats, timed);
+    Game game(pack, do_shuffle, points_to_win, players);
+    game.set_sink(transcript);
+
+    unique_ptr<RecordSink> record;
+    unique_ptr<TeeSink> both;
+    if (record_file.is_open()) {
+      record.reset(new RecordSink(record_file, names, points_to_win));
+      both.reset(new TeeSink(transcript, *record));
+      game.set_sink(*both);
+    }
+    if (opts.seeded) game.set_rng(&rng);
+    game.play();
+
+    // The writer only finds out a write failed once it makes it, so wait
+    // for the last of the transcript before checking
+    out->flush();
+    if (!*out || (writer && !writer->good())) {
+      cerr << "Error writing the transcript" << endl;
+      status = 1;
+    }
 
-  // Clean up players created by Player_factory
-  for (Player* p : players) delete p;
+    // Clean up players created by Player_factory
+    for (Player* p : players) delete p;
+  } else {
+    const GameStats stats = simulate(pack, seats, opts, do_shuffle,
+                                       points_to_win, timed,
+                                       record_file.is_open() ? &record_file
+                                                             : nullptr);
+    print_stats(stats, opts.simulate_games, seats);
+  }
+  if (record_file.is_open() && !record_file.flush()) {
+    cout << "Error writing " << opts.record_filename << endl;
+    status = 1;
+  }
 
-  return 0;
+  reporter.reset();
+  if (timed) {
+    latencies.print(cerr);
+  }
+
+  return status;
 }
@@ -0,0 +1,108 @@
+// history.cpp
+// Adds recorded games to a hand history, indexes it, and finds hands in it
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "HandHistory.hpp"
+
+using namespace std;
+
+static void print_usage_and_exit() {
+  cout << "Usage: history.exe HISTORY_FILENAME add RECORD_FILENAME..." << endl
+       << "       history.exe HISTORY_FILENAME index" << endl
+       << "       history.exe HISTORY_FILENAME find [--game ID] [--deal DEAL] "
+       << "[--march] [--euchred]" << endl;
+  exit(1);
+}
+
+// Appends every game in the record files to the history
+static int add(const string &path, int argc, char **argv) {
+  HandHistoryWriter writer;
+  if (!writer.open(path)) {
+    cout << "Error opening " << path << endl;
+    return 1;
+  }
+  for (int i = 3; i < argc; ++i) {
+    ifstream in(argv[i], ios::binary);
+    string preamble;
+    if (!read_record_preamble(in, preamble)) {
+      cout << "Error reading " << argv[i] << endl;
+      return 1;
+    }
+    GameRecord record;
+    ReadResult result;
+    while ((result = read_game_record(in, record)) == READ_OK) {
+      if (!writer.append(record)) {
+        cout << "Error writing " << path << endl;
+        return 1;
+      }
+    }
+    if (result == READ_ERROR) {
+      cout << "Error reading " << argv[i] << endl;
+      return 1;
+    }
+  }
+  cout << writer.next_game_id() << " games" << endl;
+  return 0;
+}
+
+// Prints one line per hand matching the flags from argv[3] on
+static int find(const string &path, int argc, char **argv) {
+  HandQuery query;
+  for (int i = 3; i < argc; ++i) {
+    const string flag = argv[i];
+    if (flag == "--game" && i + 1 < argc) {
+      query.game_id = strtoll(argv[++i], nullptr, 10);
+    } else if (flag == "--deal" && i + 1 < argc) {
+      query.deal = strtoll(argv[++i], nullptr, 10);
+    } else if (flag == "--march") {
+      query.flags |= HandEntry::MARCH;
+    } else if (flag == "--euchred") {
+      query.flags |= HandEntry::EUCHRED;
+    } else {
+      print_usage_and_exit();
+    }
+  }
+
+  HandHistory history;
+  if (!history.open(path)) {
+    cout << "Error opening " << path << endl;
+    return 1;
+  }
+  for (size_t i : history.find(query)) {
+    const HandEntry &entry = history[i];
+    HandRecord hand;
+    if (!entry.record(hand)) {
+      cout << "Error reading hand " << i << " of " << path << endl;
+      return 1;
+    }
+    cout << "game " << entry.game_id << " hand " << entry.hand_number
+         << " deal " << entry.deal() << " upcard " << hand.upcard
+         << " maker " << entry.maker_seat() << " round " << entry.round()
+         << " trump " << hand.trump << " tricks " << entry.maker_tricks()
+         << (entry.has(HandEntry::MARCH) ? " march" : "")
+         << (entry.has(HandEntry::EUCHRED) ? " euchred" : "") << '\n';
+  }
+  cout << flush;
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) print_usage_and_exit();
+  const string path = argv[1];
+  const string command = argv[2];
+  if (command == "add" && argc > 3) {
+    return add(path, argc, argv);
+  } else if (command == "index" && argc == 3) {
+    if (!HandHistory::build_index(path)) {
+      cout << "Error indexing " << path << endl;
+      return 1;
+    }
+    return 0;
+  } else if (command == "find") {
+    return find(path, argc, argv);
+  }
+  print_usage_and_exit();
+}
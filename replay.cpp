@@ -0,0 +1,49 @@
+// replay.cpp
+// Prints the transcripts of games recorded with euchre.exe --record
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "GameRecord.hpp"
+
+using namespace std;
+
+static void print_usage_and_exit() {
+  cout << "Usage: replay.exe RECORD_FILENAME [GAME]" << endl;
+  exit(1);
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3) print_usage_and_exit();
+  const int only = argc == 3 ? atoi(argv[2]) : -1; // -1 prints every game
+  if (argc == 3 && only < 0) print_usage_and_exit();
+
+  ifstream in(argv[1], ios::binary);
+  if (!in.is_open()) {
+    cout << "Error opening " << argv[1] << endl;
+    return 1;
+  }
+
+  // The command line that played the games comes first, as it did then
+  string preamble;
+  if (!read_record_preamble(in, preamble)) {
+    cout << "Error reading " << argv[1] << endl;
+    return 1;
+  }
+  cout << preamble;
+
+  GameRecord record;
+  int game = 0;
+  ReadResult result;
+  for (; (result = read_game_record(in, record)) == READ_OK; ++game) {
+    if (only < 0 || game == only) {
+      replay_game(record, cout);
+    }
+  }
+  if (result == READ_ERROR || (only >= 0 && game <= only)) {
+    cout << "Error reading game " << game << " of " << argv[1] << endl;
+    return 1;
+  }
+  return 0;
+}